@@ -0,0 +1,166 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "midi.h"
+#include "midi-buffer.h"
+#include "Catch.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+
+/*
+    ByteCursor offers the same operations as the istream based read functions,
+    but works on bytes that are already in memory (typically a MidiBuffer).
+    These tests check that both give the same results.
+*/
+
+
+namespace
+{
+    ByteCursor cursor_over(const char* buffer, size_t size)
+    {
+        return ByteCursor(reinterpret_cast<const uint8_t*>(buffer), size);
+    }
+}
+
+TEST_CASE("ByteCursor, reading uint32_t from { 0x12, 0x34, 0x56, 0x78 }")
+{
+    char buffer[] = { 0x12, 0x34, 0x56, 0x78 };
+    ByteCursor cursor = cursor_over(buffer, sizeof(buffer));
+    uint32_t x;
+
+    REQUIRE(read(cursor, &x));
+    CHECK(x == 0x78563412);
+    CHECK(cursor.at_end());
+    CHECK(!cursor.failed());
+}
+
+TEST_CASE("ByteCursor, reading uint32_t from { 0x12, 0x34, 0x56 } fails")
+{
+    char buffer[] = { 0x12, 0x34, 0x56 };
+    ByteCursor cursor = cursor_over(buffer, sizeof(buffer));
+    uint32_t x;
+
+    REQUIRE(!read(cursor, &x));
+    CHECK(cursor.failed());
+}
+
+TEST_CASE("ByteCursor, reading bytes")
+{
+    char buffer[] = { 0x12, 0x34 };
+    ByteCursor cursor = cursor_over(buffer, sizeof(buffer));
+
+    CHECK(read_byte(cursor) == 0x12);
+    CHECK(read_byte(cursor) == 0x34);
+    CHECK(!cursor.failed());
+    CHECK(read_byte(cursor) == 0);
+    CHECK(cursor.failed());
+}
+
+TEST_CASE("ByteCursor, reading variable length integers")
+{
+    char buffer[] = { 0x00, 0x7F, char(0x81), 0x00, char(0x82), char(0xE5), 0x51, char(0xFF), char(0xFF), char(0xFF), 0x7F };
+    ByteCursor cursor = cursor_over(buffer, sizeof(buffer));
+
+    CHECK(read_variable_length_integer(cursor) == 0);
+    CHECK(read_variable_length_integer(cursor) == 0x7F);
+    CHECK(read_variable_length_integer(cursor) == 0x80);
+    CHECK(read_variable_length_integer(cursor) == 0b1011'0010'1101'0001);
+    CHECK(read_variable_length_integer(cursor) == 0x0FFFFFFF);
+    CHECK(cursor.at_end());
+    CHECK(!cursor.failed());
+}
+
+TEST_CASE("ByteCursor, reading truncated variable length integer fails")
+{
+    char buffer[] = { char(0x81), char(0x80) };
+    ByteCursor cursor = cursor_over(buffer, sizeof(buffer));
+
+    read_variable_length_integer(cursor);
+    CHECK(cursor.failed());
+}
+
+TEST_CASE("ByteCursor, reading CHUNK_HEADER and MThd")
+{
+    char buffer[] = {
+        'M', 'T', 'h', 'd', 0x00, 0x00, 0x00, 0x06, 0x00, 0x01, 0x00, 0x02, 0x01, char(0x80),
+        'M', 'T', 'r', 'k', 0x01, 0x02, 0x03, 0x04
+    };
+    ByteCursor cursor = cursor_over(buffer, sizeof(buffer));
+    MThd mthd;
+    CHUNK_HEADER header;
+
+    REQUIRE(read_mthd(cursor, &mthd));
+    CHECK(mthd.header.size == 6);
+    CHECK(mthd.type == 1);
+    CHECK(mthd.ntracks == 2);
+    CHECK(mthd.division == 0x0180);
+
+    REQUIRE(read_header(cursor, &header));
+    CHECK(header_id(header) == "MTrk");
+    CHECK(header.size == 0x01020304);
+    CHECK(cursor.at_end());
+}
+
+TEST_CASE("ByteCursor, split")
+{
+    char buffer[] = { 1, 2, 3, 4, 5 };
+    ByteCursor cursor = cursor_over(buffer, sizeof(buffer));
+    ByteCursor part = cursor.split(3);
+
+    CHECK(part.remaining() == 3);
+    CHECK(cursor.remaining() == 2);
+    CHECK(read_byte(part) == 1);
+    CHECK(read_byte(cursor) == 4);
+
+    ByteCursor too_long = cursor.split(2);
+    CHECK(too_long.failed());
+    CHECK(cursor.failed());
+}
+
+TEST_CASE("MidiBuffer, loading from stream")
+{
+    char buffer[] = { 'M', 'T', 'h', 'd', 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x05, 0x02, 0x01 };
+    std::string data(buffer, sizeof(buffer));
+    std::stringstream ss(data);
+    MidiBuffer midi;
+
+    REQUIRE(midi.load(ss));
+    REQUIRE(midi.size() == sizeof(buffer));
+
+    ByteCursor cursor = midi.cursor();
+    MThd mthd;
+    REQUIRE(read_mthd(cursor, &mthd));
+    CHECK(mthd.ntracks == 5);
+}
+
+TEST_CASE("MidiBuffer, mapping a file")
+{
+    char buffer[] = { 'M', 'T', 'r', 'k', 0x00, 0x00, 0x00, 0x04, 0x00, char(0xFF), 0x2F, 0x00 };
+    const char* path = "midi-buffer-test.tmp";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(buffer, sizeof(buffer));
+    }
+
+    {
+        MidiBuffer midi;
+        REQUIRE(midi.open(path));
+        REQUIRE(midi.size() == sizeof(buffer));
+
+        MidiBuffer moved(std::move(midi));
+        ByteCursor cursor = moved.cursor();
+        CHUNK_HEADER header;
+        REQUIRE(read_header(cursor, &header));
+        CHECK(header.size == 4);
+    }
+
+    std::remove(path);
+
+    MidiBuffer missing;
+    CHECK(!missing.open(path));
+}
+
+#endif
@@ -0,0 +1,131 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "io.h"
+#include "Catch.h"
+#include <sstream>
+#include <vector>
+
+
+/*
+    read_variable_length_integers decodes many variable length integers in one call.
+    It must agree with read_variable_length_integer(std::istream&) on every input,
+    including the ones from 04-read-variable-sized-integer.cpp.
+*/
+
+
+namespace
+{
+    std::vector<std::vector<uint8_t>> encodings()
+    {
+        return {
+            { 0x00 },
+            { 0x01 },
+            { 0x7F },
+            { 0x81, 0x00 },
+            { 0x81, 0x80, 0x00 },
+            { 0x81, 0x80, 0x80, 0x00 },
+            { 0b10000001, 0b10000001, 0b10000001, 0b00000001 },
+            { 0b10000111, 0b10010001, 0b11010101, 0b00000000 },
+            { 0b00000111 },
+            { 0xFF, 0x7F },
+            { 0xFF, 0xFF, 0xFF, 0x7F },
+        };
+    }
+
+    std::vector<uint32_t> expected_values(const std::vector<uint8_t>& bytes, size_t count)
+    {
+        std::string data(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        std::stringstream ss(data);
+        std::vector<uint32_t> result;
+
+        for (size_t i = 0; i != count; ++i)
+        {
+            result.push_back(read_variable_length_integer(ss));
+        }
+
+        return result;
+    }
+
+    void check_batch(const std::vector<uint8_t>& bytes, size_t count)
+    {
+        std::vector<uint32_t> expected = expected_values(bytes, count);
+        std::vector<uint32_t> actual(count);
+        ByteCursor cursor(bytes.data(), bytes.size());
+
+        REQUIRE(read_variable_length_integers(cursor, actual.data(), count) == count);
+        CHECK(cursor.at_end());
+        CHECK(!cursor.failed());
+        CHECK(actual == expected);
+    }
+}
+
+TEST_CASE("Batched variable length integers, single values")
+{
+    for (auto& encoding : encodings())
+    {
+        check_batch(encoding, 1);
+    }
+}
+
+TEST_CASE("Batched variable length integers, one byte values only")
+{
+    std::vector<uint8_t> bytes;
+
+    for (int i = 0; i != 100; ++i)
+    {
+        bytes.push_back(uint8_t(i));
+    }
+
+    check_batch(bytes, bytes.size());
+}
+
+TEST_CASE("Batched variable length integers, mixed lengths")
+{
+    std::vector<uint8_t> bytes;
+    size_t count = 0;
+
+    for (int round = 0; round != 20; ++round)
+    {
+        for (auto& encoding : encodings())
+        {
+            bytes.insert(bytes.end(), encoding.begin(), encoding.end());
+            ++count;
+        }
+    }
+
+    check_batch(bytes, count);
+}
+
+TEST_CASE("Batched variable length integers, value longer than a vector block")
+{
+    std::vector<uint8_t> bytes(20, 0x80);
+    bytes.push_back(0x05);
+    bytes.push_back(0x06);
+
+    check_batch(bytes, 2);
+}
+
+TEST_CASE("Batched variable length integers, stops at count")
+{
+    std::vector<uint8_t> bytes(64, 0x01);
+    uint32_t values[10];
+    ByteCursor cursor(bytes.data(), bytes.size());
+
+    REQUIRE(read_variable_length_integers(cursor, values, 10) == 10);
+    CHECK(cursor.remaining() == 54);
+}
+
+TEST_CASE("Batched variable length integers, truncated last value")
+{
+    std::vector<uint8_t> bytes(40, 0x01);
+    bytes.push_back(0x81);
+    std::vector<uint32_t> values(41);
+    ByteCursor cursor(bytes.data(), bytes.size());
+
+    CHECK(read_variable_length_integers(cursor, values.data(), values.size()) == 40);
+    CHECK(cursor.failed());
+}
+
+#endif
@@ -0,0 +1,74 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "endianness.h"
+#include "Catch.h"
+#include <vector>
+
+
+/*
+    load_be16 and load_be32 read big-endian integers straight from a byte buffer.
+    swap_endianness does the same as switch_endianness, but for a whole array at once.
+*/
+
+
+namespace
+{
+    constexpr uint8_t bytes[] = { 0x12, 0x34, 0x56, 0x78 };
+
+    static_assert(load_be16(bytes) == 0x1234, "load_be16 should be usable at compile time");
+    static_assert(load_be32(bytes) == 0x12345678, "load_be32 should be usable at compile time");
+    static_assert(byte_swap16(0x1234) == 0x3412, "byte_swap16 should be usable at compile time");
+    static_assert(byte_swap32(0x12345678) == 0x78563412, "byte_swap32 should be usable at compile time");
+}
+
+TEST_CASE("load_be16 and load_be32 from unaligned memory")
+{
+    uint8_t buffer[] = { 0xFF, 0xAA, 0xBB, 0xCC, 0xDD };
+
+    CHECK(load_be16(buffer + 1) == 0xAABB);
+    CHECK(load_be32(buffer + 1) == 0xAABBCCDD);
+}
+
+TEST_CASE("Bulk swapping endianness of uint16_t values")
+{
+    for (size_t count = 0; count != 40; ++count)
+    {
+        std::vector<uint16_t> values(count);
+        std::vector<uint16_t> expected(count);
+
+        for (size_t i = 0; i != count; ++i)
+        {
+            values[i] = uint16_t(0x0102 + i * 0x0305);
+            expected[i] = values[i];
+            switch_endianness(&expected[i]);
+        }
+
+        swap_endianness(values.data(), values.size());
+
+        CHECK(values == expected);
+    }
+}
+
+TEST_CASE("Bulk swapping endianness of uint32_t values")
+{
+    for (size_t count = 0; count != 40; ++count)
+    {
+        std::vector<uint32_t> values(count);
+        std::vector<uint32_t> expected(count);
+
+        for (size_t i = 0; i != count; ++i)
+        {
+            values[i] = uint32_t(0x01020304 + i * 0x05060708);
+            expected[i] = values[i];
+            switch_endianness(&expected[i]);
+        }
+
+        swap_endianness(values.data(), values.size());
+
+        CHECK(values == expected);
+    }
+}
+
+#endif
@@ -0,0 +1,112 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "chunk-index.h"
+#include "Catch.h"
+
+
+/*
+    A ChunkIndex lists every chunk in a MIDI file (offset, id and size)
+    after a single pass that only looks at the chunk headers.
+*/
+
+
+namespace
+{
+    const uint8_t* bytes_of(const char* buffer)
+    {
+        return reinterpret_cast<const uint8_t*>(buffer);
+    }
+}
+
+TEST_CASE("ChunkIndex, MThd followed by two tracks and an unknown chunk")
+{
+    char buffer[] = {
+        'M', 'T', 'h', 'd', 0x00, 0x00, 0x00, 0x06, 0x00, 0x01, 0x00, 0x02, 0x01, 0x00,
+        'M', 'T', 'r', 'k', 0x00, 0x00, 0x00, 0x04, 0x00, char(0xFF), 0x2F, 0x00,
+        'X', 'Y', 'Z', 'W', 0x00, 0x00, 0x00, 0x02, 0x12, 0x34,
+        'M', 'T', 'r', 'k', 0x00, 0x00, 0x00, 0x05, 0x01, 0x00, char(0xFF), 0x2F, 0x00,
+    };
+    ChunkIndex index;
+
+    REQUIRE(index.build(bytes_of(buffer), sizeof(buffer)));
+    REQUIRE(index.chunks().size() == 4);
+    CHECK(!index.is_truncated());
+
+    REQUIRE(index.header_chunk() != nullptr);
+    CHECK(index.header_chunk()->header.size == 6);
+
+    CHECK(index.chunks()[1].kind == ChunkKind::MTrk);
+    CHECK(index.chunks()[1].offset == 14);
+    CHECK(index.chunks()[2].kind == ChunkKind::Unknown);
+    CHECK(header_id(index.chunks()[2].header) == "XYZW");
+    CHECK(index.chunks()[2].offset == 26);
+    CHECK(index.chunks()[3].offset == 36);
+
+    REQUIRE(index.track_count() == 2);
+
+    SECTION("Tracks can be opened in any order")
+    {
+        ByteCursor second = index.track(1);
+        CHUNK_HEADER header;
+        REQUIRE(read_header(second, &header));
+        CHECK(header.size == 5);
+        CHECK(read_byte(second) == 0x01);
+
+        ByteCursor first = index.chunk_data(index.track_entry(0));
+        CHECK(first.remaining() == 4);
+        CHECK(read_byte(first) == 0x00);
+        CHECK(read_byte(first) == 0xFF);
+    }
+}
+
+TEST_CASE("ChunkIndex, truncated chunk data")
+{
+    char buffer[] = {
+        'M', 'T', 'h', 'd', 0x00, 0x00, 0x00, 0x06, 0x00, 0x01, 0x00, 0x01, 0x01, 0x00,
+        'M', 'T', 'r', 'k', 0x00, 0x00, 0x00, 0x08, 0x00, char(0xFF), 0x2F, 0x00,
+    };
+    ChunkIndex index;
+
+    REQUIRE(!index.build(bytes_of(buffer), sizeof(buffer)));
+    CHECK(index.is_truncated());
+    CHECK(index.chunks().size() == 1);
+    CHECK(index.track_count() == 0);
+}
+
+TEST_CASE("ChunkIndex, truncated chunk header")
+{
+    char buffer[] = {
+        'M', 'T', 'h', 'd', 0x00, 0x00, 0x00, 0x06, 0x00, 0x01, 0x00, 0x01, 0x01, 0x00,
+        'M', 'T', 'r',
+    };
+    ChunkIndex index;
+
+    REQUIRE(!index.build(bytes_of(buffer), sizeof(buffer)));
+    CHECK(index.is_truncated());
+}
+
+TEST_CASE("ChunkIndex, empty file")
+{
+    ChunkIndex index;
+
+    REQUIRE(index.build(nullptr, 0));
+    CHECK(index.chunks().empty());
+    CHECK(index.header_chunk() == nullptr);
+}
+
+TEST_CASE("ChunkIndex, sample file 04.mid")
+{
+    MidiBuffer buffer;
+    REQUIRE(buffer.open("../midi-files/04.mid"));
+
+    ChunkIndex index;
+    REQUIRE(index.build(buffer));
+    CHECK(index.track_count() == 22);
+
+    const CHUNK_ENTRY& last = index.track_entry(21);
+    CHECK(last.offset + sizeof(CHUNK_HEADER) + last.header.size == buffer.size());
+}
+
+#endif
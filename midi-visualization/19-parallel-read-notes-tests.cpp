@@ -0,0 +1,102 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "midi.h"
+#include "midi-buffer.h"
+#include "Catch.h"
+#include <string>
+#include <vector>
+
+
+/*
+    read_notes_parallel decodes the tracks of a format 1 file on several threads.
+    Its output must be identical to that of read_notes, whatever the number of threads.
+*/
+
+
+namespace
+{
+    void check_same_as_serial(const std::string& path)
+    {
+        MidiBuffer buffer;
+        REQUIRE(buffer.open(path));
+
+        std::vector<NOTE> expected;
+        REQUIRE(read_notes(buffer, &expected));
+        CHECK(!expected.empty());
+
+        for (unsigned threads : { 1u, 2u, 3u, 8u, 0u })
+        {
+            std::vector<NOTE> actual;
+            REQUIRE(read_notes_parallel(buffer, &actual, threads));
+            CHECK(actual == expected);
+        }
+    }
+}
+
+TEST_CASE("read_notes_parallel, sample files give the same notes as read_notes")
+{
+    for (const char* name : { "01", "02", "03", "04", "05", "06", "07", "08", "09", "10" })
+    {
+        INFO(name);
+        check_same_as_serial(std::string("../midi-files/") + name + ".mid");
+    }
+}
+
+TEST_CASE("read_notes_parallel, two notes on different tracks")
+{
+    char buffer[] = {
+        'M', 'T', 'h', 'd',
+        0x00, 0x00, 0x00, 0x06, // MThd size
+        0x00, 0x01, // Type
+        0x00, 0x02, // Number of tracks
+        0x01, 0x00, // Division
+        'M', 'T', 'r', 'k',
+        0x00, 0x00, 0x00, 12, // MTrk size
+        0, char(0b1001'0000), 5, char(255), // Note on
+        100, char(0b1000'0000), 5, char(255), // Note off
+        0x00, char(0xFF), 0x2F, 0x00, // End of track
+        'M', 'T', 'r', 'k',
+        0x00, 0x00, 0x00, 12, // MTrk size
+        0, char(0b1001'0000), 88, char(255), // Note on
+        100, char(0b1000'0000), 88, char(255), // Note off
+        0x00, char(0xFF), 0x2F, 0x00 // End of track
+    };
+    std::string data(buffer, sizeof(buffer));
+    std::stringstream ss(data);
+    MidiBuffer midi;
+    REQUIRE(midi.load(ss));
+
+    std::vector<NOTE> notes;
+    REQUIRE(read_notes_parallel(midi, &notes, 2));
+    REQUIRE(notes.size() == 2);
+    CHECK(notes[0] == NOTE{ 0, 5, 0, 100 });
+    CHECK(notes[1] == NOTE{ 0, 88, 0, 100 });
+}
+
+TEST_CASE("read_notes_parallel, broken track")
+{
+    char buffer[] = {
+        'M', 'T', 'h', 'd',
+        0x00, 0x00, 0x00, 0x06, // MThd size
+        0x00, 0x01, // Type
+        0x00, 0x02, // Number of tracks
+        0x01, 0x00, // Division
+        'M', 'T', 'r', 'k',
+        0x00, 0x00, 0x00, 4, // MTrk size
+        0x00, char(0xFF), 0x2F, 0x00, // End of track
+        'M', 'T', 'r', 'k',
+        0x00, 0x00, 0x00, 4, // MTrk size
+        0x00, char(0xFF), 0x2E, 0x00 // No end of track
+    };
+    std::string data(buffer, sizeof(buffer));
+    std::stringstream ss(data);
+    MidiBuffer midi;
+    REQUIRE(midi.load(ss));
+
+    std::vector<NOTE> notes;
+    CHECK(!read_notes_parallel(midi, &notes, 2));
+}
+
+#endif
@@ -0,0 +1,176 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "tests-util.h"
+#include "mtrk-parser.h"
+#include "midi-buffer.h"
+#include "chunk-index.h"
+#include <vector>
+
+using namespace testutils;
+
+
+/*
+    MtrkParser must find the same events as read_mtrk, no matter
+    how the bytes of the track are split into fragments.
+*/
+
+
+namespace
+{
+    const char track[] = {
+        'M', 'T', 'r', 'k',
+        0x00, 0x00, 0x00, 31, // Length
+        char(0x81), 0x00, char(0b1001'0000), 50, 100, // Note on, two byte dt
+        0, 49, 101, // Note on, running status
+        0, char(0xFF), 0x05, 0x03, 'a', 'b', 'c', // Meta
+        0, 48, 102, // Note on, running status after meta
+        10, char(0xF0), 0x02, 1, 2, // Sysex
+        5, char(0b1110'0011), 0x34, 0x12, // Pitch wheel change
+        0x00, char(0xFF), 0x2F, 0x00 // End of track
+    };
+
+    std::unique_ptr<TestEventReceiver> expected_receiver()
+    {
+        char metadata[] { 'a', 'b', 'c' };
+        char sysexdata[] { 1, 2 };
+
+        return Builder()
+            .note_on(128, 0, 50, 100)
+            .note_on(0, 0, 49, 101)
+            .meta(0, 0x05, metadata, sizeof(metadata))
+            .note_on(0, 0, 48, 102)
+            .sysex(10, sysexdata, sizeof(sysexdata))
+            .pitch_wheel_change(5, 3, 0x1234)
+            .meta(0, 0x2F, nullptr, 0)
+            .build();
+    }
+
+    MtrkParser::Status feed_in_pieces(MtrkParser& parser, const uint8_t* data, size_t size, size_t piece)
+    {
+        MtrkParser::Status status = MtrkParser::Status::NeedMoreData;
+
+        for (size_t i = 0; i < size && status == MtrkParser::Status::NeedMoreData; i += piece)
+        {
+            status = parser.feed(data + i, std::min(piece, size - i));
+        }
+
+        return status;
+    }
+}
+
+TEST_CASE("MtrkParser, whole track at once")
+{
+    auto receiver = expected_receiver();
+    MtrkParser parser(*receiver);
+
+    REQUIRE(parser.feed(reinterpret_cast<const uint8_t*>(track), sizeof(track)) == MtrkParser::Status::Finished);
+    receiver->check_finished();
+}
+
+TEST_CASE("MtrkParser, track in fragments of every size")
+{
+    for (size_t piece = 1; piece != sizeof(track); ++piece)
+    {
+        INFO("Fragment size " << piece);
+
+        auto receiver = expected_receiver();
+        MtrkParser parser(*receiver);
+
+        REQUIRE(feed_in_pieces(parser, reinterpret_cast<const uint8_t*>(track), sizeof(track), piece) == MtrkParser::Status::Finished);
+        receiver->check_finished();
+    }
+}
+
+TEST_CASE("MtrkParser, bytes after the track are not consumed")
+{
+    std::vector<uint8_t> data(track, track + sizeof(track));
+    data.push_back('M');
+    auto receiver = expected_receiver();
+    MtrkParser parser(*receiver);
+    size_t consumed;
+
+    REQUIRE(parser.feed(data.data(), data.size(), &consumed) == MtrkParser::Status::Finished);
+    CHECK(consumed == sizeof(track));
+}
+
+TEST_CASE("MtrkParser, wrong chunk id")
+{
+    char buffer[] = { 'M', 'T', 'h', 'd', 0x00, 0x00, 0x00, 0x04, 0x00, char(0xFF), 0x2F, 0x00 };
+    auto receiver = Builder().build();
+    MtrkParser parser(*receiver);
+
+    CHECK(parser.feed(reinterpret_cast<const uint8_t*>(buffer), sizeof(buffer)) == MtrkParser::Status::Error);
+}
+
+TEST_CASE("MtrkParser, erroneous length (too small)")
+{
+    char buffer[] = {
+        'M', 'T', 'r', 'k',
+        0x00, 0x00, 0x00, 11, // Length
+        0, char(0b1001'0000), 0, 0, // Note on
+        10, char(0b1000'0000), 0, 0, // Note off
+        0x00, char(0xFF), 0x2F, 0x00 // End of track
+    };
+    auto receiver = Builder().note_on(0, 0, 0, 0).note_off(10, 0, 0, 0).build();
+    MtrkParser parser(*receiver);
+
+    CHECK(parser.feed(reinterpret_cast<const uint8_t*>(buffer), sizeof(buffer)) == MtrkParser::Status::Error);
+}
+
+TEST_CASE("MtrkParser, erroneous length (too large)")
+{
+    char buffer[] = {
+        'M', 'T', 'r', 'k',
+        0x00, 0x00, 0x00, 13, // Length
+        0, char(0b1001'0000), 0, 0, // Note on
+        10, char(0b1000'0000), 0, 0, // Note off
+        0x00, char(0xFF), 0x2F, 0x00, // End of track
+        0x00
+    };
+    auto receiver = Builder().note_on(0, 0, 0, 0).note_off(10, 0, 0, 0).meta(0, 0x2F, nullptr, 0).build();
+    MtrkParser parser(*receiver);
+
+    CHECK(parser.feed(reinterpret_cast<const uint8_t*>(buffer), sizeof(buffer)) == MtrkParser::Status::Error);
+}
+
+TEST_CASE("MtrkParser, incomplete track needs more data")
+{
+    auto receiver = Builder().note_on(128, 0, 50, 100).build();
+    MtrkParser parser(*receiver);
+
+    CHECK(parser.feed(reinterpret_cast<const uint8_t*>(track), 14) == MtrkParser::Status::NeedMoreData);
+    CHECK(parser.status() == MtrkParser::Status::NeedMoreData);
+    receiver->check_finished();
+}
+
+TEST_CASE("MtrkParser, notes of sample file 04.mid in 100 byte fragments")
+{
+    MidiBuffer buffer;
+    REQUIRE(buffer.open("../midi-files/04.mid"));
+    ChunkIndex index;
+    REQUIRE(index.build(buffer));
+
+    for (size_t i = 0; i != index.track_count(); ++i)
+    {
+        std::vector<NOTE> expected;
+        ByteCursor cursor = index.track(i);
+        REQUIRE(read_track_notes(cursor, &expected));
+
+        std::vector<NOTE> actual;
+        std::vector<std::shared_ptr<EventReceiver>> filters;
+        for (uint8_t channel = 0; channel != 16; ++channel)
+        {
+            filters.push_back(std::make_shared<NoteFilter>(channel, &actual));
+        }
+        EventMulticaster multicaster(filters);
+        MtrkParser parser(multicaster);
+
+        ByteCursor track = index.track(i);
+        REQUIRE(feed_in_pieces(parser, track.position(), track.remaining(), 100) == MtrkParser::Status::Finished);
+        CHECK(actual == expected);
+    }
+}
+
+#endif
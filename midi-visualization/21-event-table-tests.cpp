@@ -0,0 +1,72 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "event-table.h"
+#include "Catch.h"
+
+
+/*
+    event_table maps each status byte to the kind of event it starts,
+    the number of data bytes that follow and whether it sets the running status.
+*/
+
+
+static_assert(event_table[0x90].event_class == EventClass::NoteOn, "event_table should be built at compile time");
+static_assert(event_table[0xC5].data_length == 1, "event_table should be built at compile time");
+static_assert(!event_table[0xFF].running_status, "event_table should be built at compile time");
+
+
+TEST_CASE("event_table, data bytes")
+{
+    for (unsigned status = 0; status != 0x80; ++status)
+    {
+        CHECK(event_table[uint8_t(status)].event_class == EventClass::Data);
+        CHECK(!event_table[uint8_t(status)].running_status);
+    }
+}
+
+TEST_CASE("event_table, channel events")
+{
+    struct { uint8_t high_nibble; EventClass event_class; uint8_t data_length; } expected[] = {
+        { 0x8, EventClass::NoteOff, 2 },
+        { 0x9, EventClass::NoteOn, 2 },
+        { 0xA, EventClass::PolyphonicKeyPressure, 2 },
+        { 0xB, EventClass::ControlChange, 2 },
+        { 0xC, EventClass::ProgramChange, 1 },
+        { 0xD, EventClass::ChannelPressure, 1 },
+        { 0xE, EventClass::PitchWheelChange, 2 },
+    };
+
+    for (auto& e : expected)
+    {
+        for (uint8_t channel = 0; channel != 16; ++channel)
+        {
+            const EVENT_INFO& info = event_table[uint8_t((e.high_nibble << 4) | channel)];
+
+            CHECK(info.event_class == e.event_class);
+            CHECK(info.data_length == e.data_length);
+            CHECK(info.running_status);
+        }
+    }
+}
+
+TEST_CASE("event_table, system events")
+{
+    CHECK(event_table[0xFF].event_class == EventClass::Meta);
+    CHECK(event_table[0xF0].event_class == EventClass::Sysex);
+    CHECK(event_table[0xF7].event_class == EventClass::Sysex);
+
+    for (unsigned status : { 0xF1, 0xF2, 0xF3, 0xF6, 0xF8, 0xFA, 0xFE })
+    {
+        CHECK(event_table[uint8_t(status)].event_class == EventClass::Invalid);
+    }
+
+    for (unsigned status = 0xF0; status != 0x100; ++status)
+    {
+        CHECK(!event_table[uint8_t(status)].running_status);
+        CHECK(event_table[uint8_t(status)].data_length == 0);
+    }
+}
+
+#endif
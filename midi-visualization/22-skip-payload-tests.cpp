@@ -0,0 +1,104 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "midi.h"
+#include "mtrk-parser.h"
+#include "Catch.h"
+#include <sstream>
+#include <vector>
+
+
+/*
+    Receivers that return false from wants_meta()/wants_sysex() never see those events.
+    Their dt must not get lost: it is added to the dt of the next event they do receive.
+*/
+
+
+namespace
+{
+    class NoteOnlyReceiver : public EventReceiver
+    {
+    public:
+        std::vector<uint32_t> note_on_dts;
+        int skipped_calls = 0;
+
+        bool wants_meta() const override { return false; }
+        bool wants_sysex() const override { return false; }
+
+        void note_on(uint32_t dt, uint8_t, uint8_t, uint8_t) override { note_on_dts.push_back(dt); }
+        void note_off(uint32_t, uint8_t, uint8_t, uint8_t) override { }
+        void polyphonic_key_pressure(uint32_t, uint8_t, uint8_t, uint8_t) override { }
+        void control_change(uint32_t, uint8_t, uint8_t, uint8_t) override { }
+        void program_change(uint32_t, uint8_t, uint8_t) override { }
+        void channel_pressure(uint32_t, uint8_t, uint8_t) override { }
+        void pitch_wheel_change(uint32_t, uint8_t, uint16_t) override { }
+        void meta(uint32_t, uint8_t, const char*, int) override { ++skipped_calls; }
+        void sysex(uint32_t, const char*, int) override { ++skipped_calls; }
+    };
+
+    const char track[] = {
+        'M', 'T', 'r', 'k',
+        0x00, 0x00, 0x00, 33, // Length
+        5, char(0b1001'0000), 50, 100, // Note on
+        10, char(0xFF), 0x05, 0x03, 'a', 'b', 'c', // Lyric
+        20, char(0xF0), 0x02, 1, 2, // Sysex
+        1, char(0b1001'0000), 51, 100, // Note on
+        7, char(0xFF), 0x01, 0x02, 'x', 'y', // Text
+        2, 52, 100, // Note on, running status
+        0x00, char(0xFF), 0x2F, 0x00 // End of track
+    };
+}
+
+TEST_CASE("read_mtrk skips unwanted meta and sysex events, keeping their dt")
+{
+    std::string data(track, sizeof(track));
+    std::stringstream ss(data);
+    NoteOnlyReceiver receiver;
+
+    REQUIRE(read_mtrk(ss, receiver));
+    CHECK(receiver.skipped_calls == 0);
+    CHECK(receiver.note_on_dts == std::vector<uint32_t>{ 5, 31, 9 });
+}
+
+TEST_CASE("MtrkParser skips unwanted meta and sysex events, keeping their dt")
+{
+    for (size_t piece = 1; piece != sizeof(track); ++piece)
+    {
+        NoteOnlyReceiver receiver;
+        MtrkParser parser(receiver);
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(track);
+        MtrkParser::Status status = MtrkParser::Status::NeedMoreData;
+
+        for (size_t i = 0; i < sizeof(track) && status == MtrkParser::Status::NeedMoreData; i += piece)
+        {
+            status = parser.feed(bytes + i, std::min(piece, sizeof(track) - i));
+        }
+
+        REQUIRE(status == MtrkParser::Status::Finished);
+        CHECK(receiver.skipped_calls == 0);
+        CHECK(receiver.note_on_dts == std::vector<uint32_t>{ 5, 31, 9 });
+    }
+}
+
+TEST_CASE("NoteFilter durations include the dt of skipped meta events")
+{
+    char buffer[] = {
+        'M', 'T', 'r', 'k',
+        0x00, 0x00, 0x00, 16, // Length
+        0, char(0b1001'0000), 5, char(255), // Note on
+        50, char(0xFF), 0x01, 0x00, // Text
+        50, char(0b1000'0000), 5, char(255), // Note off
+        0x00, char(0xFF), 0x2F, 0x00 // End of track
+    };
+    std::string data(buffer, sizeof(buffer));
+    std::stringstream ss(data);
+    std::vector<NOTE> notes;
+    NoteFilter filter(0, &notes);
+
+    REQUIRE(read_mtrk(ss, filter));
+    REQUIRE(notes.size() == 1);
+    CHECK(notes[0] == NOTE{ 0, 5, 0, 100 });
+}
+
+#endif
@@ -0,0 +1,135 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "midi.h"
+#include "tests-util.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace testutils;
+
+
+/*
+    read_notes_fast must return exactly the same notes, in the same order, as read_notes.
+    The inputs below are those of 12-read-notes-tests.cpp plus the sample files.
+*/
+
+
+namespace
+{
+    void check_same_as_read_notes(const char* buffer, size_t size)
+    {
+        std::string data(buffer, size);
+        std::vector<NOTE> expected;
+        std::vector<NOTE> actual;
+
+        std::stringstream expected_stream(data);
+        bool expected_result = read_notes(expected_stream, &expected);
+
+        std::stringstream actual_stream(data);
+        CHECK(read_notes_fast(actual_stream, &actual) == expected_result);
+        CHECK(actual == expected);
+    }
+}
+
+TEST_CASE("read_notes_fast, single note")
+{
+    char buffer[] = {
+        'M', 'T', 'h', 'd', 0x00, 0x00, 0x00, 0x06, 0x00, 0x01, 0x00, 0x01, 0x01, 0x00,
+        'M', 'T', 'r', 'k', 0x00, 0x00, 0x00, 12,
+        0, char(0b1001'0000), 5, char(255), // Note on
+        100, char(0b1000'0000), 5, char(255), // Note off
+        0x00, char(0xFF), 0x2F, 0x00 // End of track
+    };
+
+    check_same_as_read_notes(buffer, sizeof(buffer));
+}
+
+TEST_CASE("read_notes_fast, two notes on same track different channels")
+{
+    char buffer[] = {
+        'M', 'T', 'h', 'd', 0x00, 0x00, 0x00, 0x06, 0x00, 0x01, 0x00, 0x01, 0x01, 0x00,
+        'M', 'T', 'r', 'k', 0x00, 0x00, 0x00, 20,
+        0, char(0b1001'0000), 5, char(255), // Note on
+        100, char(0b1000'0000), 5, char(255), // Note off
+        100, char(0b1001'0010), 8, char(255), // Note on
+        100, char(0b1000'0010), 8, char(255), // Note off
+        0x00, char(0xFF), 0x2F, 0x00 // End of track
+    };
+
+    check_same_as_read_notes(buffer, sizeof(buffer));
+}
+
+TEST_CASE("read_notes_fast, two notes on different tracks")
+{
+    char buffer[] = {
+        'M', 'T', 'h', 'd', 0x00, 0x00, 0x00, 0x06, 0x00, 0x01, 0x00, 0x02, 0x01, 0x00,
+        'M', 'T', 'r', 'k', 0x00, 0x00, 0x00, 12,
+        0, char(0b1001'0000), 5, char(255), // Note on
+        100, char(0b1000'0000), 5, char(255), // Note off
+        0x00, char(0xFF), 0x2F, 0x00, // End of track
+        'M', 'T', 'r', 'k', 0x00, 0x00, 0x00, 12,
+        0, char(0b1001'0000), 88, char(255), // Note on
+        100, char(0b1000'0000), 88, char(255), // Note off
+        0x00, char(0xFF), 0x2F, 0x00 // End of track
+    };
+
+    check_same_as_read_notes(buffer, sizeof(buffer));
+}
+
+TEST_CASE("read_notes_fast, running status, velocity 0 and other events")
+{
+    char buffer[] = {
+        'M', 'T', 'h', 'd', 0x00, 0x00, 0x00, 0x06, 0x00, 0x01, 0x00, 0x01, 0x01, 0x00,
+        'M', 'T', 'r', 'k', 0x00, 0x00, 0x00, 37,
+        0, char(0b1001'0000), 5, char(255), // Note on
+        0, 6, char(255), // Note on
+        3, char(0b1011'0000), 7, 100, // Control change
+        2, 8, 90, // Control change, running status
+        1, char(0b1100'0001), 3, // Program change
+        4, char(0xF0), 0x01, 0x7F, // Sysex
+        50, char(0xFF), 0x01, 0x01, 'x', // Text
+        40, char(0b1001'0000), 5, 0, // Note "off"
+        0, 6, 0, // Note "off"
+        0x00, char(0xFF), 0x2F, 0x00, // End of track
+    };
+
+    check_same_as_read_notes(buffer, sizeof(buffer));
+
+    std::string data(buffer, sizeof(buffer));
+    std::stringstream ss(data);
+    std::vector<NOTE> notes;
+    REQUIRE(read_notes_fast(ss, &notes));
+    REQUIRE(notes.size() == 2);
+    CHECK(notes[0] == NOTE{ 0, 5, 0, 100 });
+    CHECK(notes[1] == NOTE{ 0, 6, 0, 100 });
+}
+
+TEST_CASE("read_notes_fast, missing track")
+{
+    char buffer[] = {
+        'M', 'T', 'h', 'd', 0x00, 0x00, 0x00, 0x06, 0x00, 0x01, 0x00, 0x01, 0x01, 0x00,
+    };
+    std::string data(buffer, sizeof(buffer));
+    std::stringstream ss(data);
+    std::vector<NOTE> notes;
+
+    REQUIRE(!read_notes_fast(ss, &notes));
+}
+
+TEST_CASE("read_notes_fast, sample files")
+{
+    for (const char* name : sample_names)
+    {
+        INFO(name);
+
+        MidiBuffer buffer = load_sample(name);
+        std::vector<NOTE> actual;
+        REQUIRE(read_notes_fast(buffer, &actual));
+        CHECK(actual == load_sample_notes(name));
+    }
+}
+
+#endif
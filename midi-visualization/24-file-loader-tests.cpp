@@ -0,0 +1,155 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "file-loader.h"
+#include "midi-buffer.h"
+#include "bitmap.h"
+#include "Catch.h"
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+
+/*
+    read_file and LoadedFile read a whole file at once, either with a single read
+    or, above FileLoadOptions::map_threshold, by mapping it into memory.
+    Both ways must give the same bytes.
+*/
+
+
+namespace
+{
+    std::vector<uint8_t> write_test_file(const char* path, size_t size)
+    {
+        std::vector<uint8_t> contents(size);
+
+        for (size_t i = 0; i != size; ++i)
+        {
+            contents[i] = uint8_t(i * 7 + i / 256);
+        }
+
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(contents.data()), contents.size());
+
+        return contents;
+    }
+
+    std::vector<uint8_t> contents_of(const LoadedFile& file)
+    {
+        return std::vector<uint8_t>(file.data(), file.data() + file.size());
+    }
+}
+
+TEST_CASE("read_file, reads whole file into allocated memory")
+{
+    const char* path = "file-loader-test.tmp";
+    std::vector<uint8_t> expected = write_test_file(path, 100000);
+    std::vector<uint8_t> actual;
+    int allocations = 0;
+
+    bool result = read_file(path, [&](size_t size) {
+        ++allocations;
+        actual.resize(size);
+        return actual.data();
+    });
+
+    std::remove(path);
+
+    REQUIRE(result);
+    CHECK(allocations == 1);
+    CHECK(actual == expected);
+}
+
+TEST_CASE("read_file, missing file")
+{
+    int allocations = 0;
+
+    CHECK(!read_file("file-loader-missing.tmp", [&](size_t) -> uint8_t* { ++allocations; return nullptr; }));
+    CHECK(allocations == 0);
+}
+
+TEST_CASE("LoadedFile, reading and mapping give the same contents")
+{
+    const char* path = "file-loader-test.tmp";
+    std::vector<uint8_t> expected = write_test_file(path, 70000);
+
+    FileLoadOptions read_options;
+    read_options.map_threshold = std::numeric_limits<size_t>::max();
+    FileLoadOptions map_options;
+    map_options.map_threshold = 0;
+    map_options.sequential = false;
+
+    LoadedFile read;
+    LoadedFile mapped;
+    REQUIRE(read.open(path, read_options));
+    REQUIRE(mapped.open(path, map_options));
+
+    std::remove(path);
+
+    CHECK(!read.mapped());
+    CHECK(mapped.mapped());
+    CHECK(contents_of(read) == expected);
+    CHECK(contents_of(mapped) == expected);
+
+    LoadedFile moved(std::move(mapped));
+    CHECK(mapped.size() == 0);
+    CHECK(contents_of(moved) == expected);
+}
+
+TEST_CASE("LoadedFile, empty file")
+{
+    const char* path = "file-loader-test.tmp";
+    write_test_file(path, 0);
+
+    FileLoadOptions map_options;
+    map_options.map_threshold = 0;
+
+    LoadedFile file;
+    REQUIRE(file.open(path, map_options));
+    std::remove(path);
+
+    CHECK(file.size() == 0);
+    CHECK(!file.mapped());
+}
+
+TEST_CASE("MidiBuffer, small files are read, large files are mapped")
+{
+    const char* path = "file-loader-test.tmp";
+    std::vector<uint8_t> expected = write_test_file(path, 5000);
+
+    FileLoadOptions map_options;
+    map_options.map_threshold = 4096;
+    FileLoadOptions read_options;
+    read_options.map_threshold = 8192;
+
+    MidiBuffer mapped;
+    MidiBuffer read;
+    REQUIRE(mapped.open(path, map_options));
+    REQUIRE(read.open(path, read_options));
+    std::remove(path);
+
+    CHECK(std::vector<uint8_t>(mapped.data(), mapped.data() + mapped.size()) == expected);
+    CHECK(std::vector<uint8_t>(read.data(), read.data() + read.size()) == expected);
+}
+
+TEST_CASE("Bitmap, load reads what save wrote")
+{
+    const char* path = "bitmap-loader-test.tmp";
+    Bitmap original(5, 3, [](const Position2D& p) {
+        return p.x == p.y ? colors::white() : p.x > p.y ? Color(1, 0, 0) : colors::black();
+    });
+    original.save(path);
+
+    Bitmap loaded = Bitmap::load(path);
+    std::remove(path);
+
+    REQUIRE(loaded.width() == original.width());
+    REQUIRE(loaded.height() == original.height());
+    original.for_each_position([&](const Position2D& p) {
+        CHECK(loaded[p] == original[p]);
+    });
+}
+
+#endif
@@ -0,0 +1,214 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "mtrk-validator.h"
+#include "tests-util.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace testutils;
+
+
+/*
+    validate_mtrk_events checks the events of an MTrk chunk (without its header)
+    and reports the offset of the first problem it finds.
+*/
+
+
+namespace
+{
+    bool validate(const std::vector<uint8_t>& events, VALIDATION_ERROR* error)
+    {
+        return validate_mtrk_events(events.data(), events.size(), error);
+    }
+
+    void check_rejected_at(const std::vector<uint8_t>& events, size_t offset)
+    {
+        VALIDATION_ERROR error{ 0, nullptr };
+
+        REQUIRE(!validate(events, &error));
+        CHECK(error.offset == offset);
+        CHECK(error.reason != nullptr);
+    }
+}
+
+TEST_CASE("validate_mtrk_events, well formed track")
+{
+    std::vector<uint8_t> events = {
+        0x00, 0x90, 5, 100, // Note on
+        0x81, 0x00, 6, 100, // Note on, running status
+        0x10, 0xF0, 0x02, 0x01, 0xF7, // Sysex
+        0x00, 0xFF, 0x01, 0x02, 'h', 'i', // Text
+        0x00, 0xC3, 0x01, // Program change
+        0x83, 0x80, 0x80, 0x00, 0x80, 5, 0, // Note off, 4 byte delta time
+        0x00, 0xFF, 0x2F, 0x00 // End of track
+    };
+
+    CHECK(validate(events, nullptr));
+}
+
+TEST_CASE("validate_mtrk_events, counts note ons")
+{
+    std::vector<uint8_t> events = {
+        0x00, 0x90, 5, 100, // Note on
+        0x00, 6, 100, // Note on, running status
+        0x00, 5, 0, // Velocity 0 is a note off
+        0x00, 0x81, 6, 0, // Note off
+        0x00, 0x9F, 7, 1, // Note on
+        0x00, 0xFF, 0x2F, 0x00
+    };
+    size_t note_ons = 0;
+
+    REQUIRE(validate_mtrk_events(events.data(), events.size(), nullptr, &note_ons));
+    CHECK(note_ons == 3);
+}
+
+TEST_CASE("validate_mtrk_events, missing end of track")
+{
+    check_rejected_at({ 0x00, 0x90, 5, 100 }, 4);
+    check_rejected_at({}, 0);
+}
+
+TEST_CASE("validate_mtrk_events, data after end of track")
+{
+    check_rejected_at({ 0x00, 0xFF, 0x2F, 0x00, 0x00 }, 4);
+}
+
+TEST_CASE("validate_mtrk_events, delta time longer than 4 bytes")
+{
+    check_rejected_at({ 0x00, 0x90, 5, 100, 0x81, 0x80, 0x80, 0x80, 0x00, 0xFF, 0x2F, 0x00 }, 4);
+}
+
+TEST_CASE("validate_mtrk_events, delta time cut off")
+{
+    check_rejected_at({ 0x00, 0x90, 5, 100, 0x81 }, 4);
+}
+
+TEST_CASE("validate_mtrk_events, data byte without running status")
+{
+    check_rejected_at({ 0x00, 5, 100, 0x00, 0xFF, 0x2F, 0x00 }, 1);
+}
+
+TEST_CASE("validate_mtrk_events, invalid status byte")
+{
+    check_rejected_at({ 0x00, 0xF2, 0x00, 0x00, 0x00, 0xFF, 0x2F, 0x00 }, 1);
+}
+
+TEST_CASE("validate_mtrk_events, channel event cut off")
+{
+    check_rejected_at({ 0x00, 0x90, 5 }, 1);
+}
+
+TEST_CASE("validate_mtrk_events, meta payload outside chunk")
+{
+    check_rejected_at({ 0x00, 0xFF, 0x01, 0x05, 'a', 'b' }, 1);
+    check_rejected_at({ 0x00, 0xFF, 0x2F, 0x01 }, 1);
+}
+
+TEST_CASE("validate_mtrk_events, sysex payload outside chunk")
+{
+    check_rejected_at({ 0x00, 0xF0, 0x7F, 0x01 }, 1);
+}
+
+TEST_CASE("validate_midi, offset counts from start of file")
+{
+    char buffer[] = {
+        'M', 'T', 'h', 'd', 0x00, 0x00, 0x00, 0x06, 0x00, 0x01, 0x00, 0x02, 0x01, 0x00,
+        'M', 'T', 'r', 'k', 0x00, 0x00, 0x00, 4,
+        0x00, char(0xFF), 0x2F, 0x00,
+        'M', 'T', 'r', 'k', 0x00, 0x00, 0x00, 8,
+        0x00, 0x05, 0x00, 0x00, // Data byte without running status
+        0x00, char(0xFF), 0x2F, 0x00
+    };
+    std::string data(buffer, sizeof(buffer));
+    std::stringstream ss(data);
+    MidiBuffer midi;
+    REQUIRE(midi.load(ss));
+
+    VALIDATION_ERROR error{ 0, nullptr };
+    REQUIRE(!validate_midi(midi, &error));
+    CHECK(error.offset == 35);
+
+    std::vector<NOTE> notes;
+    error.offset = 0;
+    CHECK(!read_notes_fast(midi, &notes, &error));
+    CHECK(error.offset == 35);
+}
+
+TEST_CASE("validate_midi, missing track")
+{
+    char buffer[] = {
+        'M', 'T', 'h', 'd', 0x00, 0x00, 0x00, 0x06, 0x00, 0x01, 0x00, 0x02, 0x01, 0x00,
+        'M', 'T', 'r', 'k', 0x00, 0x00, 0x00, 4,
+        0x00, char(0xFF), 0x2F, 0x00,
+    };
+    std::string data(buffer, sizeof(buffer));
+    std::stringstream ss(data);
+    MidiBuffer midi;
+    REQUIRE(midi.load(ss));
+
+    VALIDATION_ERROR error{ 0, nullptr };
+    REQUIRE(!validate_midi(midi, &error));
+    CHECK(error.offset == sizeof(buffer));
+}
+
+TEST_CASE("validate_midi, truncated chunk")
+{
+    char buffer[] = {
+        'M', 'T', 'h', 'd', 0x00, 0x00, 0x00, 0x06, 0x00, 0x01, 0x00, 0x01, 0x01, 0x00,
+        'M', 'T', 'r', 'k', 0x00, 0x00, 0x00, 8,
+        0x00, char(0xFF), 0x2F, 0x00,
+    };
+    std::string data(buffer, sizeof(buffer));
+    std::stringstream ss(data);
+    MidiBuffer midi;
+    REQUIRE(midi.load(ss));
+
+    VALIDATION_ERROR error{ 0, nullptr };
+    REQUIRE(!validate_midi(midi, &error));
+    CHECK(error.offset == 14);
+}
+
+TEST_CASE("validate_midi, sample files")
+{
+    for (const char* name : sample_names)
+    {
+        INFO(name);
+
+        // Every note has a note on of its own
+        size_t note_ons = 0;
+        CHECK(validate_midi(load_sample(name), nullptr, nullptr, nullptr, &note_ons));
+        CHECK(note_ons >= load_sample_notes(name).size());
+    }
+}
+
+TEST_CASE("validate_midi, hands over the chunk index and MThd it built")
+{
+    ChunkIndex index;
+    MThd mthd;
+
+    // The same index is reused for every file
+    for (const char* name : { "01", "10", "harmonies" })
+    {
+        INFO(name);
+
+        MidiBuffer buffer = load_sample(name);
+        REQUIRE(validate_midi(buffer, nullptr, &index, &mthd));
+
+        ChunkIndex expected;
+        REQUIRE(expected.build(buffer));
+        CHECK(index.chunks().size() == expected.chunks().size());
+        CHECK(index.track_count() >= mthd.ntracks);
+        CHECK(index.track(0).position() == expected.track(0).position());
+
+        ByteCursor cursor = buffer.cursor();
+        MThd direct;
+        REQUIRE(read_mthd(cursor, &direct));
+        CHECK(mthd.ntracks == direct.ntracks);
+        CHECK(mthd.division == direct.division);
+    }
+}
+
+#endif
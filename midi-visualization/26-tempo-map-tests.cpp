@@ -0,0 +1,131 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "tempo-map.h"
+#include "Catch.h"
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+TEST_CASE("TempoMap, default tempo is 120 bpm")
+{
+    TempoMap tempo_map(96, {});
+
+    CHECK(tempo_map.microseconds(0) == 0);
+    CHECK(tempo_map.microseconds(96) == 500000);
+    CHECK(tempo_map.microseconds(48) == 250000);
+    CHECK(tempo_map.seconds(960) == Approx(5.0));
+}
+
+TEST_CASE("TempoMap, tempo changes")
+{
+    TempoMap tempo_map(100, { { 200, 1000000 }, { 100, 250000 } });
+
+    CHECK(tempo_map.segment_count() == 3);
+    CHECK(tempo_map.microseconds(100) == 500000);
+    CHECK(tempo_map.microseconds(150) == 625000);
+    CHECK(tempo_map.microseconds(200) == 750000);
+    CHECK(tempo_map.microseconds(300) == 1750000);
+}
+
+TEST_CASE("TempoMap, last change on the same tick wins")
+{
+    TempoMap tempo_map(100, { { 0, 100000 }, { 0, 200000 } });
+
+    CHECK(tempo_map.segment_count() == 1);
+    CHECK(tempo_map.microseconds(100) == 200000);
+}
+
+TEST_CASE("TempoMap, SMPTE division")
+{
+    // 25 frames per second, 40 ticks per frame: one tick is 1 ms
+    TempoMap tempo_map(uint16_t((uint8_t(-25) << 8) | 40), { { 10, 100000 } });
+
+    CHECK(tempo_map.microseconds(1) == 1000);
+    CHECK(tempo_map.microseconds(1000) == 1000000);
+
+    // 29.97 frames per second, 1 tick per frame
+    TempoMap drop_frame(uint16_t((uint8_t(-29) << 8) | 1), {});
+
+    CHECK(drop_frame.microseconds(30000) == 1001000000);
+}
+
+TEST_CASE("TempoMap, convert agrees with microseconds")
+{
+    std::vector<TEMPO_CHANGE> changes;
+    for (uint32_t i = 1; i != 50; ++i)
+    {
+        changes.push_back(TEMPO_CHANGE{ i * 97, 300000 + i * 12345 });
+    }
+    TempoMap tempo_map(480, changes);
+
+    std::vector<NOTE> notes;
+    for (uint32_t i = 0; i != 2000; ++i)
+    {
+        notes.push_back(NOTE{ uint8_t(i % 16), uint8_t(i % 128), i * 3, (i * 7919) % 1000 });
+    }
+
+    std::vector<NOTE_TIME> times;
+    tempo_map.convert(notes, &times);
+
+    REQUIRE(times.size() == notes.size());
+    for (size_t i = 0; i != notes.size(); ++i)
+    {
+        uint64_t start = tempo_map.microseconds(notes[i].start);
+        uint64_t end = tempo_map.microseconds(uint64_t(notes[i].start) + notes[i].duration);
+
+        CHECK(times[i].start == start);
+        CHECK(times[i].duration == end - start);
+    }
+}
+
+TEST_CASE("TempoMap, convert with notes that end past 2^32 ticks")
+{
+    TempoMap tempo_map(96, { TEMPO_CHANGE{ 96, 250000 }, TEMPO_CHANGE{ 0xFFFFFF80u, 1000000 } });
+
+    std::vector<NOTE> notes = { NOTE{ 0, 60, 0xFFFFFF00u, 0x200 }, NOTE{ 0, 61, 0xFFFFFFFFu, 0xFFFFFFFFu } };
+    std::vector<NOTE_TIME> times;
+    tempo_map.convert(notes, &times);
+
+    // 0x80 ticks at 250000 µs per quarter note, then 0x180 ticks at 1000000
+    REQUIRE(times.size() == 2);
+    CHECK(times[0].start == tempo_map.microseconds(0xFFFFFF00u));
+    CHECK(times[0].duration == 0x80 * 250000 / 96 + 0x180 * 1000000 / 96);
+    CHECK(times[1].duration == 0xFFFFFFFFull * 1000000 / 96);
+    CHECK(tempo_map.microseconds(0x100000100ull) == times[0].start + times[0].duration);
+}
+
+TEST_CASE("read_tempo_changes, collects set tempo events")
+{
+    char buffer[] = {
+        'M', 'T', 'h', 'd', 0x00, 0x00, 0x00, 0x06, 0x00, 0x01, 0x00, 0x02, 0x00, 0x60,
+        'M', 'T', 'r', 'k', 0x00, 0x00, 0x00, 18,
+        0x00, char(0xFF), 0x51, 0x03, 0x07, char(0xA1), 0x20, // 500000
+        0x60, char(0xFF), 0x51, 0x03, 0x03, char(0xD0),char(0x90), // 250000 at tick 96
+        0x00, char(0xFF), 0x2F, 0x00,
+        'M', 'T', 'r', 'k', 0x00, 0x00, 0x00, 12,
+        0x00, char(0x90), 60, 100,
+        0x7F, char(0x80), 60, 0,
+        0x00, char(0xFF), 0x2F, 0x00,
+    };
+    std::string data(buffer, sizeof(buffer));
+    std::stringstream ss(data);
+    MidiBuffer midi;
+    REQUIRE(midi.load(ss));
+
+    uint16_t division;
+    std::vector<TEMPO_CHANGE> changes;
+    REQUIRE(read_tempo_changes(midi, &division, &changes));
+    CHECK(division == 96);
+    REQUIRE(changes.size() == 2);
+    CHECK(changes[1].tick == 96);
+    CHECK(changes[1].microseconds_per_quarter_note == 250000);
+
+    TempoMap tempo_map(division, changes);
+    CHECK(tempo_map.microseconds(96 + 96) == 750000);
+}
+
+#endif
@@ -0,0 +1,105 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "batch-ingest.h"
+#include "work-stealing-pool.h"
+#include "midi-buffer.h"
+#include "Catch.h"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+TEST_CASE("WorkStealingPool, runs all tasks including nested ones")
+{
+    std::atomic<int> count(0);
+    WorkStealingPool pool(4);
+
+    for (int i = 0; i != 100; ++i)
+    {
+        pool.submit([&pool, &count]() {
+            for (int j = 0; j != 10; ++j)
+            {
+                pool.submit([&count]() { ++count; });
+            }
+
+            ++count;
+        });
+    }
+
+    pool.wait();
+    CHECK(count == 1100);
+
+    pool.submit([&count]() { ++count; });
+    pool.wait();
+    CHECK(count == 1101);
+}
+
+TEST_CASE("list_midi_files, directory")
+{
+    std::vector<std::string> paths;
+
+    REQUIRE(list_midi_files("../midi-files", &paths));
+    REQUIRE(paths.size() == 13);
+    CHECK(paths.front() == "../midi-files/01.mid");
+    CHECK(paths.back() == "../midi-files/stairs.mid");
+}
+
+TEST_CASE("list_midi_files, single file")
+{
+    std::vector<std::string> paths;
+
+    REQUIRE(list_midi_files("../midi-files/04.mid", &paths));
+    REQUIRE(paths.size() == 1);
+    CHECK(paths[0] == "../midi-files/04.mid");
+}
+
+TEST_CASE("process_files, same notes as read_notes with and without splitting")
+{
+    std::vector<std::string> paths;
+    REQUIRE(list_midi_files("../midi-files", &paths));
+    paths.push_back("../midi-files/missing.mid");
+
+    // 0 opens every file by itself (split or handed to the context), 4096 mixes that with files read into the arena
+    for (size_t split_threshold : { size_t(0), size_t(4096), size_t(1) << 30 })
+    {
+        INFO(split_threshold);
+
+        std::mutex mutex;
+        std::map<std::string, std::vector<NOTE>> results;
+        BATCH_OPTIONS options;
+        options.thread_count = 4;
+        options.split_threshold = split_threshold;
+
+        BATCH_STATISTICS statistics = process_files(paths, options, [&](const std::string& path, const NOTE* notes, size_t count) {
+            std::lock_guard<std::mutex> lock(mutex);
+            results[path].assign(notes, notes + count);
+        });
+
+        CHECK(statistics.files == 14);
+        CHECK(statistics.failed == 1);
+        REQUIRE(results.size() == 13);
+
+        uint64_t bytes = 0;
+        uint64_t notes = 0;
+        for (size_t i = 0; i + 1 != paths.size(); ++i)
+        {
+            MidiBuffer buffer;
+            std::vector<NOTE> expected;
+            REQUIRE(buffer.open(paths[i]));
+            REQUIRE(read_notes(buffer, &expected));
+
+            CHECK(results[paths[i]] == expected);
+            bytes += buffer.size();
+            notes += expected.size();
+        }
+
+        CHECK(statistics.bytes == bytes);
+        CHECK(statistics.notes == notes);
+    }
+}
+
+#endif
@@ -0,0 +1,145 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "arena.h"
+#include "parse-context.h"
+#include "tests-util.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace testutils;
+
+
+TEST_CASE("Arena, allocations are aligned and do not overlap")
+{
+    Arena arena(64);
+
+    char* a = static_cast<char*>(arena.allocate(3, 1));
+    uint32_t* b = static_cast<uint32_t*>(arena.allocate(sizeof(uint32_t), alignof(uint32_t)));
+    uint64_t* c = static_cast<uint64_t*>(arena.allocate(100 * sizeof(uint64_t), alignof(uint64_t)));
+
+    CHECK(reinterpret_cast<uintptr_t>(b) % alignof(uint32_t) == 0);
+    CHECK(reinterpret_cast<uintptr_t>(c) % alignof(uint64_t) == 0);
+    CHECK(reinterpret_cast<char*>(b) >= a + 3);
+    CHECK(arena.bytes_used() >= 3 + sizeof(uint32_t) + 100 * sizeof(uint64_t));
+
+    for (int i = 0; i != 100; ++i)
+    {
+        c[i] = i;
+    }
+    *b = 7;
+    CHECK(c[99] == 99);
+    CHECK(*b == 7);
+}
+
+TEST_CASE("Arena, reset merges blocks into one")
+{
+    Arena arena(64);
+
+    for (int i = 0; i != 20; ++i)
+    {
+        arena.allocate(50);
+    }
+
+    size_t reserved = arena.bytes_reserved();
+    CHECK(reserved >= 20 * 50);
+
+    arena.reset();
+    CHECK(arena.bytes_used() == 0);
+    CHECK(arena.bytes_reserved() == reserved);
+
+    for (int i = 0; i != 20; ++i)
+    {
+        arena.allocate(50);
+    }
+    CHECK(arena.bytes_reserved() == reserved);
+}
+
+TEST_CASE("Arena, deallocating the last allocation")
+{
+    Arena arena(1024);
+
+    void* a = arena.allocate(100, 1);
+    void* b = arena.allocate(100, 1);
+    arena.deallocate(a, 100);
+    CHECK(arena.bytes_used() == 200);
+    arena.deallocate(b, 100);
+    CHECK(arena.bytes_used() == 100);
+}
+
+TEST_CASE("ArenaVector, behaves like a vector")
+{
+    Arena arena(16);
+    ArenaVector<NOTE> notes{ ArenaAllocator<NOTE>(arena) };
+
+    for (uint32_t i = 0; i != 1000; ++i)
+    {
+        notes.push_back(NOTE{ uint8_t(i % 16), uint8_t(i % 128), i, 1 });
+    }
+
+    REQUIRE(notes.size() == 1000);
+    CHECK(notes[999] == NOTE{ 999 % 16, 999 % 128, 999, 1 });
+}
+
+TEST_CASE("ParseContext, same notes as read_notes and stable memory")
+{
+    ParseContext context(1024);
+
+    for (int pass = 0; pass != 2; ++pass)
+    {
+        size_t reserved = context.arena().bytes_reserved();
+
+        for (const char* name : sample_names)
+        {
+            INFO(name);
+
+            REQUIRE(context.read_notes(sample_path(name)));
+            CHECK(std::vector<NOTE>(context.notes().begin(), context.notes().end()) == load_sample_notes(name));
+        }
+
+        if (pass == 1)
+        {
+            // The first pass grew the arena to fit the biggest file; the second one must not allocate
+            CHECK(context.arena().bytes_reserved() == reserved);
+        }
+    }
+
+    CHECK(!context.read_notes("../midi-files/missing.mid"));
+}
+
+TEST_CASE("ParseContext, the notes are reserved exactly")
+{
+    // Each repeated note on (running status, same pitch) ends a note in just 3 bytes
+    const int repeats = 3000;
+    std::string track = { 0x00, char(0x90), 0x3C, 0x40 };
+    for (int i = 0; i != repeats; ++i)
+    {
+        track += { 0x00, 0x3C, 0x40 };
+    }
+    track += { 0x00, 0x3C, 0x00, 0x00, char(0xFF), 0x2F, 0x00 };
+
+    std::string file = { 'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 96, 'M', 'T', 'r', 'k' };
+    uint32_t size = uint32_t(track.size());
+    file += { char(size >> 24), char(size >> 16), char(size >> 8), char(size) };
+    file += track;
+
+    const char* path = "dense-notes-test.tmp";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(file.data(), file.size());
+    }
+
+    ParseContext context;
+    REQUIRE(context.load(path));
+    std::remove(path);
+
+    // One note on per note, counted while validating
+    REQUIRE(context.read_notes());
+    CHECK(context.notes().size() == repeats + 1);
+    CHECK(context.notes().capacity() == repeats + 1);
+}
+
+#endif
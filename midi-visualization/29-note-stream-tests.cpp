@@ -0,0 +1,141 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "note-stream.h"
+#include "note-merge.h"
+#include "tests-util.h"
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace testutils;
+
+
+namespace
+{
+    class CollectingSink : public NoteSink
+    {
+    public:
+        void notes(const NOTE* notes, size_t count) override
+        {
+            batch_sizes.push_back(count);
+            collected.insert(collected.end(), notes, notes + count);
+        }
+
+        std::vector<NOTE> collected;
+        std::vector<size_t> batch_sizes;
+    };
+
+    bool by_everything(const NOTE& a, const NOTE& b)
+    {
+        return std::tie(a.start, a.channel, a.note_index, a.duration) < std::tie(b.start, b.channel, b.note_index, b.duration);
+    }
+}
+
+TEST_CASE("stream_notes, merges tracks by start")
+{
+    char buffer[] = {
+        'M', 'T', 'h', 'd', 0x00, 0x00, 0x00, 0x06, 0x00, 0x01, 0x00, 0x02, 0x01, 0x00,
+        'M', 'T', 'r', 'k', 0x00, 0x00, 0x00, 20,
+        0, char(0x90), 5, 100, // Note on at 0
+        100, char(0x80), 5, 0, // Note off at 100
+        10, char(0x90), 6, 100, // Note on at 110
+        10, char(0x80), 6, 0, // Note off at 120
+        0x00, char(0xFF), 0x2F, 0x00,
+        'M', 'T', 'r', 'k', 0x00, 0x00, 0x00, 12,
+        50, char(0x91), 7, 100, // Note on at 50
+        10, char(0x81), 7, 0, // Note off at 60
+        0x00, char(0xFF), 0x2F, 0x00,
+    };
+    std::string data(buffer, sizeof(buffer));
+    std::stringstream ss(data);
+    MidiBuffer midi;
+    REQUIRE(midi.load(ss));
+
+    CollectingSink sink;
+    REQUIRE(stream_notes(midi, sink));
+    REQUIRE(sink.collected.size() == 3);
+    CHECK(sink.collected[0] == NOTE{ 0, 5, 0, 100 });
+    CHECK(sink.collected[1] == NOTE{ 1, 7, 50, 10 });
+    CHECK(sink.collected[2] == NOTE{ 0, 6, 110, 10 });
+}
+
+TEST_CASE("stream_notes, same start comes out in order of note on, like read_notes_sorted")
+{
+    char buffer[] = {
+        'M', 'T', 'h', 'd', 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00,
+        'M', 'T', 'r', 'k', 0x00, 0x00, 0x00, 17,
+        0, char(0x90), 5, 100, // Note on 5 at 0
+        0, 6, 100, // Note on 6 at 0
+        10, 6, 0, // Note off 6 at 10
+        10, 5, 0, // Note off 5 at 20
+        0x00, char(0xFF), 0x2F, 0x00,
+    };
+    std::string data(buffer, sizeof(buffer));
+    std::stringstream ss(data);
+    MidiBuffer midi;
+    REQUIRE(midi.load(ss));
+
+    CollectingSink sink;
+    std::vector<NOTE> sorted;
+    REQUIRE(stream_notes(midi, sink));
+    REQUIRE(read_notes_sorted(midi, &sorted));
+
+    REQUIRE(sink.collected.size() == 2);
+    CHECK(sink.collected[0] == NOTE{ 0, 5, 0, 20 });
+    CHECK(sink.collected[1] == NOTE{ 0, 6, 0, 10 });
+    CHECK(sink.collected == sorted);
+}
+
+TEST_CASE("stream_notes, rejected file sends nothing")
+{
+    char buffer[] = {
+        'M', 'T', 'h', 'd', 0x00, 0x00, 0x00, 0x06, 0x00, 0x01, 0x00, 0x01, 0x01, 0x00,
+        'M', 'T', 'r', 'k', 0x00, 0x00, 0x00, 8,
+        0, char(0x90), 5, 100,
+        100, char(0x80), 5, 0, // No end of track
+    };
+    std::string data(buffer, sizeof(buffer));
+    std::stringstream ss(data);
+    MidiBuffer midi;
+    REQUIRE(midi.load(ss));
+
+    CollectingSink sink;
+    CHECK(!stream_notes(midi, sink));
+    CHECK(sink.collected.empty());
+}
+
+TEST_CASE("stream_notes, sample files")
+{
+    for (const char* name : sample_names)
+    {
+        INFO(name);
+
+        MidiBuffer buffer = load_sample(name);
+        std::vector<NOTE> expected = load_sample_notes(name);
+
+        std::vector<NOTE> sorted;
+        REQUIRE(read_notes_sorted(buffer, &sorted));
+
+        CollectingSink sink;
+        REQUIRE(stream_notes(buffer, sink));
+        CHECK(sink.collected == sorted);
+
+        // A tiny window lets notes out of order behind long notes, but never loses any
+        CollectingSink small;
+        REQUIRE(stream_notes(buffer, small, 2));
+
+        for (size_t size : small.batch_sizes)
+        {
+            CHECK(size <= 2);
+        }
+
+        std::sort(small.collected.begin(), small.collected.end(), by_everything);
+        std::sort(expected.begin(), expected.end(), by_everything);
+        CHECK(small.collected == expected);
+    }
+}
+
+#endif
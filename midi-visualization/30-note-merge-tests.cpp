@@ -0,0 +1,125 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "note-merge.h"
+#include "tests-util.h"
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace testutils;
+
+
+namespace
+{
+    std::vector<NOTE_RUN> runs_of(const std::vector<std::vector<NOTE>>& parts)
+    {
+        std::vector<NOTE_RUN> runs;
+
+        for (auto& part : parts)
+        {
+            runs.push_back(NOTE_RUN{ part.data(), part.data() + part.size() });
+        }
+
+        return runs;
+    }
+
+    bool by_start(const NOTE& a, const NOTE& b)
+    {
+        return a.start < b.start;
+    }
+
+    bool by_everything(const NOTE& a, const NOTE& b)
+    {
+        return std::tie(a.start, a.channel, a.note_index, a.duration) < std::tie(b.start, b.channel, b.note_index, b.duration);
+    }
+}
+
+TEST_CASE("merge_note_runs, is a stable merge")
+{
+    for (size_t k : { 1, 2, 3, 5, 8, 13 })
+    {
+        INFO(k);
+
+        std::vector<std::vector<NOTE>> parts(k);
+        std::vector<NOTE> expected;
+
+        for (size_t run = 0; run != k; ++run)
+        {
+            uint32_t start = 0;
+
+            for (size_t i = 0; i != 10 + run * 7; ++i)
+            {
+                start += uint32_t((i * 31 + run * 17) % 5);
+                parts[run].push_back(NOTE{ uint8_t(run), uint8_t(i), start, 1 });
+            }
+
+            expected.insert(expected.end(), parts[run].begin(), parts[run].end());
+        }
+
+        std::stable_sort(expected.begin(), expected.end(), by_start);
+
+        std::vector<NOTE> merged;
+        merge_note_runs(runs_of(parts), &merged);
+        CHECK(merged == expected);
+    }
+}
+
+TEST_CASE("merge_note_runs, empty runs")
+{
+    std::vector<std::vector<NOTE>> parts = { {}, { NOTE{ 0, 1, 5, 1 } }, {}, { NOTE{ 0, 2, 3, 1 } } };
+    std::vector<NOTE> merged;
+
+    merge_note_runs(runs_of(parts), &merged);
+    REQUIRE(merged.size() == 2);
+    CHECK(merged[0].note_index == 2);
+    CHECK(merged[1].note_index == 1);
+
+    merged.clear();
+    merge_note_runs({}, &merged);
+    CHECK(merged.empty());
+}
+
+TEST_CASE("merge_note_runs, streaming to a sink in batches")
+{
+    class CollectingSink : public NoteSink
+    {
+    public:
+        void notes(const NOTE* notes, size_t count) override
+        {
+            CHECK(count <= 3);
+            collected.insert(collected.end(), notes, notes + count);
+        }
+
+        std::vector<NOTE> collected;
+    };
+
+    std::vector<std::vector<NOTE>> parts = { { NOTE{ 0, 1, 0, 1 }, NOTE{ 0, 1, 4, 1 } }, { NOTE{ 0, 2, 1, 1 }, NOTE{ 0, 2, 2, 1 }, NOTE{ 0, 2, 9, 1 } } };
+    CollectingSink sink;
+    merge_note_runs(runs_of(parts), sink, 3);
+
+    REQUIRE(sink.collected.size() == 5);
+    CHECK(std::is_sorted(sink.collected.begin(), sink.collected.end(), by_start));
+}
+
+TEST_CASE("read_notes_sorted, sample files")
+{
+    for (const char* name : sample_names)
+    {
+        INFO(name);
+
+        std::vector<NOTE> expected = load_sample_notes(name);
+        std::vector<NOTE> actual;
+        REQUIRE(read_notes_sorted(load_sample(name), &actual));
+
+        CHECK(std::is_sorted(actual.begin(), actual.end(), by_start));
+
+        std::sort(expected.begin(), expected.end(), by_everything);
+        std::sort(actual.begin(), actual.end(), by_everything);
+        CHECK(actual == expected);
+    }
+}
+
+#endif
@@ -0,0 +1,142 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "note-sort.h"
+#include "tests-util.h"
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace testutils;
+
+
+namespace
+{
+    bool by_key(const NOTE& a, const NOTE& b)
+    {
+        return std::tie(a.start, a.channel, a.note_index) < std::tie(b.start, b.channel, b.note_index);
+    }
+
+    // The notes of all sample files, copied over and over with shifted starts
+    std::vector<NOTE> scaled_sample_notes(size_t copies)
+    {
+        std::vector<NOTE> sample;
+
+        for (const char* name : sample_names)
+        {
+            std::vector<NOTE> notes = load_sample_notes(name);
+            sample.insert(sample.end(), notes.begin(), notes.end());
+        }
+
+        std::vector<NOTE> notes;
+        notes.reserve(sample.size() * copies);
+
+        for (size_t copy = 0; copy != copies; ++copy)
+        {
+            for (NOTE note : sample)
+            {
+                note.start += uint32_t(copy * 977);
+                notes.push_back(note);
+            }
+        }
+
+        return notes;
+    }
+}
+
+TEST_CASE("radix_sort_notes, same order as std::stable_sort")
+{
+    std::vector<NOTE> notes = scaled_sample_notes(3);
+
+    // Make the durations tell equal keys apart, so stability is checked too
+    for (size_t i = 0; i != notes.size(); ++i)
+    {
+        notes[i].duration = uint32_t(i);
+    }
+
+    std::vector<NOTE> expected = notes;
+    std::stable_sort(expected.begin(), expected.end(), by_key);
+
+    std::vector<NOTE> serial = notes;
+    radix_sort_notes(serial);
+    CHECK(serial == expected);
+
+    std::vector<NOTE> parallel = notes;
+    radix_sort_notes_parallel(parallel, 4);
+    CHECK(parallel == expected);
+}
+
+TEST_CASE("radix_sort_notes, large starts and all bytes in use")
+{
+    std::vector<NOTE> notes;
+    uint32_t x = 12345;
+
+    for (uint32_t i = 0; i != 300000; ++i)
+    {
+        x = x * 1664525 + 1013904223;
+        notes.push_back(NOTE{ uint8_t(x >> 28), uint8_t((x >> 8) & 0x7F), x, i });
+    }
+
+    std::vector<NOTE> expected = notes;
+    std::stable_sort(expected.begin(), expected.end(), by_key);
+
+    std::vector<NOTE> serial = notes;
+    radix_sort_notes(serial);
+    CHECK(serial == expected);
+
+    std::vector<NOTE> parallel = notes;
+    radix_sort_notes_parallel(parallel, 3);
+    CHECK(parallel == expected);
+}
+
+TEST_CASE("radix_sort_notes, empty and single")
+{
+    std::vector<NOTE> notes;
+    radix_sort_notes(notes);
+    radix_sort_notes_parallel(notes);
+    CHECK(notes.empty());
+
+    notes.push_back(NOTE{ 1, 2, 3, 4 });
+    radix_sort_notes(notes);
+    CHECK(notes[0] == NOTE{ 1, 2, 3, 4 });
+}
+
+// Run with the [benchmark] tag to compare the sorts
+TEST_CASE("radix_sort_notes, benchmark", "[.][benchmark]")
+{
+    std::vector<NOTE> notes = scaled_sample_notes(100);
+    std::vector<NOTE> work;
+
+    BENCHMARK("std::sort")
+    {
+        work = notes;
+        std::sort(work.begin(), work.end(), by_key);
+    }
+
+    BENCHMARK("std::stable_sort")
+    {
+        work = notes;
+        std::stable_sort(work.begin(), work.end(), by_key);
+    }
+
+    BENCHMARK("radix_sort_notes")
+    {
+        work = notes;
+        radix_sort_notes(work);
+    }
+
+    BENCHMARK("radix_sort_notes_parallel")
+    {
+        work = notes;
+        radix_sort_notes_parallel(work);
+    }
+
+    BENCHMARK("copy only")
+    {
+        work = notes;
+    }
+}
+
+#endif
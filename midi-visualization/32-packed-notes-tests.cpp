@@ -0,0 +1,74 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "packed-notes.h"
+#include "tests-util.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace testutils;
+
+
+TEST_CASE("PackedNote, is 8 bytes")
+{
+    CHECK(sizeof(PackedNote) == 8);
+}
+
+TEST_CASE("PackedNotes, round trip of simple notes")
+{
+    std::vector<NOTE> notes = {
+        NOTE{ 0, 0, 0, 0 },
+        NOTE{ 15, 127, 100, 50 },
+        NOTE{ 3, 60, 90, 1 }, // Starts before the previous note
+        NOTE{ 9, 36, 1000000, 134217727 }, // Largest duration that fits
+    };
+
+    PackedNotes packed(notes);
+
+    REQUIRE(packed.size() == notes.size());
+    CHECK(packed.exception_count() == 0);
+    CHECK(packed.unpack() == notes);
+
+    for (size_t i = 0; i != notes.size(); ++i)
+    {
+        CHECK(packed[i] == notes[i]);
+    }
+}
+
+TEST_CASE("PackedNotes, notes that do not fit are kept exactly")
+{
+    std::vector<NOTE> notes = {
+        NOTE{ 0, 1, 4000000000u, 10 },
+        NOTE{ 0, 2, 0, 10 }, // Far before the block start
+        NOTE{ 0, 3, 4000000000u, 134217728 }, // Duration too long
+        NOTE{ 16, 3, 4000000000u, 1 }, // Channel too big
+        NOTE{ 0, 200, 4000000000u, 1 }, // Note index too big
+        NOTE{ 1, 4, 4000000001u, 1 },
+    };
+
+    PackedNotes packed(notes);
+
+    CHECK(packed.exception_count() == 4);
+    CHECK(packed.unpack() == notes);
+    CHECK(packed[3] == notes[3]);
+    CHECK(packed[5] == notes[5]);
+}
+
+TEST_CASE("PackedNotes, sample files take about a third less memory")
+{
+    for (const char* name : sample_names)
+    {
+        INFO(name);
+
+        std::vector<NOTE> notes = load_sample_notes(name);
+
+        PackedNotes packed(notes);
+        CHECK(packed.unpack() == notes);
+        CHECK(packed.exception_count() == 0);
+        CHECK(packed.memory_usage() * 10 <= notes.size() * sizeof(NOTE) * 7);
+    }
+}
+
+#endif
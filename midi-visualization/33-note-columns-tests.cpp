@@ -0,0 +1,180 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "note-columns.h"
+#include "tests-util.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace testutils;
+
+
+/*
+    Every operation of NoteColumns is compared with the same computation
+    done the straightforward way on a vector of NOTEs.
+*/
+
+
+namespace
+{
+    std::vector<NOTE> all_sample_notes()
+    {
+        std::vector<NOTE> notes;
+
+        for (const char* name : sample_names)
+        {
+            std::vector<NOTE> sample = load_sample_notes(name);
+            notes.insert(notes.end(), sample.begin(), sample.end());
+        }
+
+        return notes;
+    }
+
+    template<typename Predicate>
+    std::vector<NOTE> filtered(const std::vector<NOTE>& notes, Predicate predicate)
+    {
+        std::vector<NOTE> result;
+        std::copy_if(notes.begin(), notes.end(), std::back_inserter(result), predicate);
+        return result;
+    }
+
+    std::vector<NOTE> notes_of(const NoteColumns& columns)
+    {
+        return std::vector<NOTE>(columns.begin(), columns.end());
+    }
+}
+
+TEST_CASE("NoteColumns, round trip")
+{
+    std::vector<NOTE> notes = all_sample_notes();
+    NoteColumns columns(notes);
+
+    REQUIRE(columns.size() == notes.size());
+    CHECK(notes_of(columns) == notes);
+
+    std::vector<NOTE> converted;
+    columns.to_notes(&converted);
+    CHECK(converted == notes);
+    CHECK(columns[17] == notes[17]);
+}
+
+TEST_CASE("NoteColumns, const_iterator arithmetic")
+{
+    std::vector<NOTE> notes = { NOTE{ 0, 1, 0, 1 }, NOTE{ 0, 2, 3, 1 }, NOTE{ 1, 3, 3, 2 }, NOTE{ 2, 4, 8, 1 }, NOTE{ 3, 5, 9, 1 } };
+    NoteColumns columns(notes);
+    NoteColumns::const_iterator begin = columns.begin();
+    NoteColumns::const_iterator end = columns.end();
+
+    CHECK(end - begin == 5);
+    CHECK(std::distance(begin, end) == 5);
+    CHECK(begin[2] == notes[2]);
+    CHECK(*(2 + begin) == notes[2]);
+    CHECK(*(end - 1) == notes[4]);
+    CHECK(begin->note_index == 1);
+    CHECK((begin + 3)->start == 8);
+
+    NoteColumns::const_iterator it = end;
+    it -= 2;
+    CHECK(*it-- == notes[3]);
+    CHECK(*it == notes[2]);
+    it += 1;
+    CHECK(*it == notes[3]);
+
+    CHECK(begin < end);
+    CHECK(end > begin);
+    CHECK(begin <= begin);
+    CHECK(end >= begin);
+    CHECK(!(begin > end));
+
+    auto first_at_3 = std::lower_bound(begin, end, 3u, [](const NOTE& note, uint32_t time) { return note.start < time; });
+    CHECK(first_at_3 - begin == 1);
+}
+
+TEST_CASE("NoteColumns, reductions")
+{
+    std::vector<NOTE> notes = all_sample_notes();
+
+    // Odd sizes exercise the scalar tails
+    for (size_t size : { size_t(0), size_t(1), size_t(7), size_t(33), notes.size() })
+    {
+        INFO(size);
+
+        std::vector<NOTE> part(notes.begin(), notes.begin() + size);
+        NoteColumns columns(part);
+
+        uint64_t max_end = 0;
+        uint64_t total = 0;
+        uint32_t channels[16] = {};
+        uint32_t note_counts[128] = {};
+        for (auto& note : part)
+        {
+            max_end = std::max(max_end, uint64_t(note.start) + note.duration);
+            total += note.duration;
+            ++channels[note.channel];
+            ++note_counts[note.note_index];
+        }
+
+        CHECK(columns.max_end() == max_end);
+        CHECK(columns.total_duration() == total);
+
+        uint32_t actual_channels[16];
+        columns.channel_histogram(actual_channels);
+        CHECK(std::equal(channels, channels + 16, actual_channels));
+
+        uint32_t actual_notes[128];
+        columns.note_histogram(actual_notes);
+        CHECK(std::equal(note_counts, note_counts + 128, actual_notes));
+
+        uint8_t lowest, highest;
+        if (part.empty())
+        {
+            CHECK(!columns.note_range(&lowest, &highest));
+        }
+        else
+        {
+            REQUIRE(columns.note_range(&lowest, &highest));
+            auto range = std::minmax_element(part.begin(), part.end(), [](const NOTE& a, const NOTE& b) { return a.note_index < b.note_index; });
+            CHECK(lowest == range.first->note_index);
+            CHECK(highest == range.second->note_index);
+        }
+    }
+}
+
+TEST_CASE("NoteColumns, max_end with starts above 2^31")
+{
+    NoteColumns columns(std::vector<NOTE>{ NOTE{ 0, 0, 0x90000000u, 5 }, NOTE{ 0, 0, 3, 4 }, NOTE{ 0, 0, 0x10000000u, 1 }, NOTE{ 0, 0, 0x7FFFFFFFu, 1 } });
+
+    CHECK(columns.max_end() == 0x90000005u);
+}
+
+TEST_CASE("NoteColumns, ends past 2^32 do not wrap around")
+{
+    // Five notes, so that both the SIMD loop and the scalar tail see a note that ends late
+    std::vector<NOTE> notes = { NOTE{ 0, 0, 0xFFFFFFF0u, 0x100 }, NOTE{ 0, 1, 3, 4 }, NOTE{ 0, 2, 0x10, 1 }, NOTE{ 0, 3, 5, 1 }, NOTE{ 0, 4, 0xFFFFFFFFu, 2 } };
+    NoteColumns columns(notes);
+
+    CHECK(columns.max_end() == 0x1000000F0ull);
+    CHECK(notes_of(columns.sounding_during(0xFFFFFFF8u, 0xFFFFFFFFu)) == std::vector<NOTE>{ notes[0] });
+    CHECK(notes_of(columns.sounding_during(0xFFFFFFFFu, 0xFFFFFFFFu)) == std::vector<NOTE>{ notes[0] });
+    CHECK(notes_of(columns.sounding_during(0, 0xFFFFFFFFu)) == std::vector<NOTE>(notes.begin(), notes.begin() + 4));
+    CHECK(notes_of(columns.sounding_during(0xFFFFFFFEu, 0xFFFFFFFFu)) == std::vector<NOTE>{ notes[0] });
+
+    NoteColumns tail(std::vector<NOTE>{ NOTE{ 0, 0, 0xFFFFFFF0u, 0x100 } });
+    CHECK(tail.max_end() == 0x1000000F0ull);
+    CHECK(tail.sounding_during(0xFFFFFFF8u, 0xFFFFFFFFu).size() == 1);
+}
+
+TEST_CASE("NoteColumns, filters")
+{
+    std::vector<NOTE> notes = all_sample_notes();
+    NoteColumns columns(notes);
+
+    CHECK(notes_of(columns.with_channel(9)) == filtered(notes, [](const NOTE& n) { return n.channel == 9; }));
+    CHECK(notes_of(columns.with_note_range(60, 72)) == filtered(notes, [](const NOTE& n) { return n.note_index >= 60 && n.note_index <= 72; }));
+    CHECK(notes_of(columns.sounding_during(1000, 5000)) == filtered(notes, [](const NOTE& n) { return n.start < 5000 && n.start + n.duration > 1000; }));
+    CHECK(columns.with_channel(16).empty());
+}
+
+#endif
@@ -0,0 +1,159 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "note-index.h"
+#include "tests-util.h"
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace testutils;
+
+
+/*
+    NoteIndex must find exactly the notes a linear scan finds: first the ones
+    that sound at the start of the window, then the ones that start inside it,
+    in order of start (ties: original order).
+*/
+
+
+namespace
+{
+    bool by_everything(const NOTE& a, const NOTE& b)
+    {
+        return std::tie(a.start, a.duration, a.channel, a.note_index) < std::tie(b.start, b.duration, b.channel, b.note_index);
+    }
+
+    std::vector<NOTE> sorted(std::vector<NOTE> notes)
+    {
+        std::sort(notes.begin(), notes.end(), by_everything);
+        return notes;
+    }
+
+    std::vector<NOTE> scan(const std::vector<NOTE>& notes, uint32_t from, uint32_t to)
+    {
+        std::vector<NOTE> result;
+
+        for (auto& note : notes)
+        {
+            if (note.start < to && uint64_t(note.start) + note.duration > from)
+            {
+                result.push_back(note);
+            }
+        }
+
+        std::stable_sort(result.begin(), result.end(), [](const NOTE& a, const NOTE& b) { return a.start < b.start; });
+        return result;
+    }
+}
+
+TEST_CASE("NoteIndex, agrees with a linear scan on sample files")
+{
+    for (const char* name : { "01", "05", "10", "harmonies", "lengths", "stairs" })
+    {
+        std::vector<NOTE> notes = load_sample_notes(name);
+        NoteIndex index(notes);
+        REQUIRE(index.size() == notes.size());
+
+        uint32_t last = 0;
+        for (auto& note : notes)
+        {
+            last = std::max(last, note.start + note.duration);
+        }
+
+        for (uint32_t width : { 1u, 7u, 100u, 1000u, last + 1 })
+        {
+            for (uint32_t from = 0; from <= last; from += std::max(1u, last / 50))
+            {
+                INFO(name << " [" << from << ", " << from + width << ")");
+
+                std::vector<NOTE> found;
+                index.overlapping(from, from + width, &found);
+
+                CHECK(sorted(found) == sorted(scan(notes, from, from + width)));
+
+                // The notes that start inside the window come last, in order of start
+                auto inside = std::find_if(found.begin(), found.end(), [from](const NOTE& note) { return note.start > from; });
+                CHECK(std::all_of(found.begin(), inside, [from](const NOTE& note) { return note.start <= from; }));
+                CHECK(std::all_of(inside, found.end(), [from](const NOTE& note) { return note.start > from; }));
+                CHECK(std::is_sorted(inside, found.end(), [](const NOTE& a, const NOTE& b) { return a.start < b.start; }));
+                CHECK(index.count_overlapping(from, from + width) == found.size());
+            }
+        }
+    }
+}
+
+TEST_CASE("NoteIndex, indices refer to the original vector")
+{
+    std::vector<NOTE> notes = load_sample_notes("harmonies");
+    NoteIndex index(notes);
+    std::vector<uint32_t> indices;
+    std::vector<NOTE> found;
+
+    index.overlapping_indices(0, 0xFFFFFFFFu, &indices);
+    index.overlapping(0, 0xFFFFFFFFu, &found);
+    REQUIRE(indices.size() == found.size());
+
+    for (size_t i = 0; i != indices.size(); ++i)
+    {
+        CHECK(notes[indices[i]] == found[i]);
+    }
+}
+
+TEST_CASE("NoteIndex, many long notes sounding at once")
+{
+    // Nested and staggered notes put many notes in the same tree nodes
+    std::vector<NOTE> notes;
+    for (uint32_t i = 0; i != 500; ++i)
+    {
+        notes.push_back(NOTE{ 0, uint8_t(i % 128), i * 2, 2000 - i * 3 });
+        notes.push_back(NOTE{ 1, uint8_t(i % 128), i * 5, 40 });
+        notes.push_back(NOTE{ 2, uint8_t(i % 128), i * 5, 0 });
+    }
+    NoteIndex index(notes);
+
+    for (uint32_t from = 0; from < 3000; from += 37)
+    {
+        for (uint32_t width : { 1u, 10u, 500u })
+        {
+            INFO("[" << from << ", " << from + width << ")");
+
+            std::vector<NOTE> found;
+            index.overlapping(from, from + width, &found);
+            CHECK(sorted(found) == sorted(scan(notes, from, from + width)));
+        }
+    }
+}
+
+TEST_CASE("NoteIndex, edges of the window")
+{
+    std::vector<NOTE> notes = {
+        NOTE{ 0, 60, 10, 10 },  // [10, 20)
+        NOTE{ 0, 61, 20, 5 },   // [20, 25)
+        NOTE{ 0, 62, 0, 100 },  // [0, 100)
+        NOTE{ 0, 63, 15, 0 },   // never sounds
+        NOTE{ 0, 64, 0xFFFFFFF0u, 0x100 },
+    };
+    NoteIndex index(notes);
+
+    CHECK(index.count_overlapping(20, 21) == 2);
+    CHECK(index.count_overlapping(19, 20) == 2);
+    CHECK(index.count_overlapping(25, 30) == 1);
+    CHECK(index.count_overlapping(15, 16) == 2);
+    CHECK(index.count_overlapping(10, 10) == 0);
+    CHECK(index.count_overlapping(0xFFFFFFF8u, 0xFFFFFFFFu) == 1);
+}
+
+TEST_CASE("NoteIndex, empty")
+{
+    NoteIndex index(std::vector<NOTE>{});
+    std::vector<NOTE> found;
+
+    index.overlapping(0, 1000, &found);
+    CHECK(found.empty());
+    CHECK(NoteIndex().empty());
+}
+
+#endif
@@ -0,0 +1,214 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "static-receivers.h"
+#include "tests-util.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace testutils;
+
+
+/*
+    read_mtrk<Receiver> and StaticMulticaster must deliver exactly the same events
+    as read_mtrk(ByteCursor&, EventReceiver&) and EventMulticaster.
+*/
+
+
+namespace
+{
+    // Has the nine event methods, but is not an EventReceiver and has no wants_meta/wants_sysex
+    struct EventLogger
+    {
+        std::vector<std::string> events;
+
+        void log(const char* name, uint32_t dt, int a, int b = -1)
+        {
+            events.push_back(std::string(name) + " " + std::to_string(dt) + " " + std::to_string(a) + " " + std::to_string(b));
+        }
+
+        void note_on(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) { log("on", dt, channel * 128 + note, velocity); }
+        void note_off(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) { log("off", dt, channel * 128 + note, velocity); }
+        void polyphonic_key_pressure(uint32_t dt, uint8_t channel, uint8_t note, uint8_t pressure) { log("poly", dt, channel * 128 + note, pressure); }
+        void control_change(uint32_t dt, uint8_t channel, uint8_t controller, uint8_t value) { log("cc", dt, channel * 128 + controller, value); }
+        void program_change(uint32_t dt, uint8_t channel, uint8_t program) { log("program", dt, channel, program); }
+        void channel_pressure(uint32_t dt, uint8_t channel, uint8_t pressure) { log("pressure", dt, channel, pressure); }
+        void pitch_wheel_change(uint32_t dt, uint8_t channel, uint16_t value) { log("pitch", dt, channel, value); }
+        void meta(uint32_t dt, uint8_t type, const char* data, int data_size) { log("meta", dt, type, data_size); }
+        void sysex(uint32_t dt, const char* data, int data_size) { log("sysex", dt, data_size); }
+    };
+
+    struct NoteOnLogger : EventLogger
+    {
+        bool wants_meta() const { return false; }
+        bool wants_sysex() const { return false; }
+    };
+
+    const char track_with_meta[] = {
+        'M', 'T', 'r', 'k',
+        0x00, 0x00, 0x00, 27,
+        5, char(0b1001'0000), 50, 100, // Note on
+        10, char(0xFF), 0x05, 0x03, 'a', 'b', 'c', // Lyric
+        20, char(0xF0), 0x02, 1, 2, // Sysex
+        1, char(0b1000'0000), 50, 0, // Note off
+        2, 52, 100, // Note off, running status
+        0x00, char(0xFF), 0x2F, 0x00 // End of track
+    };
+
+    template<size_t... Channels>
+    bool read_with_static_filters(ByteCursor& track, std::vector<NOTE>* notes, std::index_sequence<Channels...>)
+    {
+        NoteFilter filters[] = { NoteFilter(uint8_t(Channels), notes)... };
+        auto multicaster = make_static_multicaster(filters[Channels]...);
+
+        return read_mtrk(track, multicaster);
+    }
+
+    ByteCursor cursor_over(const char* data, size_t size)
+    {
+        return ByteCursor(reinterpret_cast<const uint8_t*>(data), size);
+    }
+}
+
+TEST_CASE("read_mtrk<Receiver> reports the same events as the virtual read_mtrk")
+{
+    for (const char* name : sample_names)
+    {
+        MidiBuffer buffer = load_sample(name);
+
+        for (ByteCursor track : track_cursors(buffer))
+        {
+            ByteCursor copy = track;
+            EventLogger direct, erased;
+            EventReceiverAdapter<EventLogger> adapter(erased);
+
+            REQUIRE(read_mtrk(track, direct));
+            REQUIRE(read_mtrk(copy, static_cast<EventReceiver&>(adapter)));
+            CHECK(direct.events == erased.events);
+            CHECK(!direct.events.empty());
+        }
+    }
+}
+
+TEST_CASE("read_mtrk<Receiver>, wants_meta and wants_sysex are optional")
+{
+    EventLogger everything;
+    ByteCursor cursor = cursor_over(track_with_meta, sizeof(track_with_meta));
+    REQUIRE(read_mtrk(cursor, everything));
+    CHECK(everything.events == std::vector<std::string>{ "on 5 50 100", "meta 10 5 3", "sysex 20 2 -1", "off 1 50 0", "off 2 52 100", "meta 0 47 0" });
+
+    NoteOnLogger notes_only;
+    cursor = cursor_over(track_with_meta, sizeof(track_with_meta));
+    REQUIRE(read_mtrk(cursor, notes_only));
+    CHECK(notes_only.events == std::vector<std::string>{ "on 5 50 100", "off 31 50 0", "off 2 52 100" });
+}
+
+TEST_CASE("read_mtrk<Receiver>, truncated track fails")
+{
+    EventLogger logger;
+    ByteCursor cursor = cursor_over(track_with_meta, sizeof(track_with_meta) - 1);
+
+    CHECK(!read_mtrk(cursor, logger));
+}
+
+TEST_CASE("StaticMulticaster gives the same notes as EventMulticaster")
+{
+    for (const char* name : sample_names)
+    {
+        MidiBuffer buffer = load_sample(name);
+
+        std::vector<NOTE> static_notes, virtual_notes;
+        NoteFilter low(0, &static_notes), drums(9, &static_notes);
+        auto multicaster = make_static_multicaster(low, drums);
+        EventMulticaster runtime({ std::make_shared<NoteFilter>(0, &virtual_notes), std::make_shared<NoteFilter>(9, &virtual_notes) });
+
+        CHECK(!multicaster.wants_meta());
+        CHECK(!multicaster.wants_sysex());
+
+        for (ByteCursor track : track_cursors(buffer))
+        {
+            ByteCursor copy = track;
+            REQUIRE(read_mtrk(track, multicaster));
+            REQUIRE(read_mtrk(copy, runtime));
+        }
+
+        CHECK(static_notes == virtual_notes);
+    }
+}
+
+TEST_CASE("StaticMulticaster, forwards to every receiver in order")
+{
+    std::vector<NOTE> notes;
+    NoteFilter filter(0, &notes);
+    EventLogger first, second;
+    auto multicaster = make_static_multicaster(first, filter, second);
+
+    CHECK(multicaster.wants_meta());
+
+    ByteCursor cursor = cursor_over(track_with_meta, sizeof(track_with_meta));
+    REQUIRE(read_mtrk(cursor, multicaster));
+
+    CHECK(first.events.size() == 6);
+    CHECK(first.events == second.events);
+    REQUIRE(notes.size() == 1);
+    CHECK(notes[0] == NOTE{ 0, 50, 5, 31 });
+}
+
+TEST_CASE("EventReceiverAdapter takes part in an EventMulticaster")
+{
+    std::vector<NOTE> notes;
+    NoteOnLogger logger;
+    EventMulticaster multicaster({ std::make_shared<EventReceiverAdapter<NoteOnLogger>>(logger), std::make_shared<NoteFilter>(0, &notes) });
+
+    CHECK(!multicaster.wants_meta());
+
+    ByteCursor cursor = cursor_over(track_with_meta, sizeof(track_with_meta));
+    REQUIRE(read_mtrk(cursor, multicaster));
+
+    CHECK(logger.events.size() == 3);
+    CHECK(notes.size() == 1);
+}
+
+// Run with the [benchmark] tag to compare virtual and static dispatch
+TEST_CASE("Static receivers, benchmark", "[.][benchmark]")
+{
+    MidiBuffer buffer = load_sample("10");
+    std::vector<ByteCursor> all_tracks = track_cursors(buffer);
+    std::vector<NOTE> notes;
+
+    BENCHMARK("16 NoteFilters, EventMulticaster")
+    {
+        for (int round = 0; round != 100; ++round)
+        {
+            notes.clear();
+            std::vector<std::shared_ptr<EventReceiver>> filters;
+            for (uint8_t channel = 0; channel != 16; ++channel)
+            {
+                filters.push_back(std::make_shared<NoteFilter>(channel, &notes));
+            }
+            EventMulticaster multicaster(filters);
+
+            for (ByteCursor track : all_tracks)
+            {
+                read_mtrk(track, static_cast<EventReceiver&>(multicaster));
+            }
+        }
+    }
+
+    BENCHMARK("16 NoteFilters, StaticMulticaster")
+    {
+        for (int round = 0; round != 100; ++round)
+        {
+            notes.clear();
+
+            for (ByteCursor track : all_tracks)
+            {
+                read_with_static_filters(track, &notes, std::make_index_sequence<16>());
+            }
+        }
+    }
+}
+
+#endif
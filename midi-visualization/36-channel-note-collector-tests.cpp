@@ -0,0 +1,137 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "midi.h"
+#include "static-receivers.h"
+#include "tests-util.h"
+#include <string>
+#include <vector>
+
+using namespace testutils;
+
+
+/*
+    ChannelNoteCollector replaces the 16 NoteFilters behind an EventMulticaster
+    from 11-multicaster-tests.cpp. It must produce the same NOTEs in the same order.
+*/
+
+
+namespace
+{
+    std::shared_ptr<EventReceiver> filter_stack(std::vector<NOTE>* notes)
+    {
+        std::vector<std::shared_ptr<EventReceiver>> filters;
+
+        for (uint8_t channel = 0; channel != 16; ++channel)
+        {
+            filters.push_back(std::make_shared<NoteFilter>(channel, notes));
+        }
+
+        return std::make_shared<EventMulticaster>(filters);
+    }
+}
+
+TEST_CASE("ChannelNoteCollector agrees with 16 NoteFilters on the sample files")
+{
+    for (const char* name : sample_names)
+    {
+        INFO(name);
+
+        MidiBuffer buffer = load_sample(name);
+
+        for (ByteCursor track : track_cursors(buffer))
+        {
+            ByteCursor copy = track;
+            std::vector<NOTE> expected, actual;
+            auto stack = filter_stack(&expected);
+            ChannelNoteCollector collector(&actual);
+
+            REQUIRE(read_mtrk(copy, *stack));
+            REQUIRE(read_mtrk(track, collector));
+            CHECK(actual == expected);
+        }
+    }
+}
+
+TEST_CASE("ChannelNoteCollector, overlapping notes on several channels")
+{
+    std::vector<NOTE> expected, actual;
+    auto stack = filter_stack(&expected);
+    ChannelNoteCollector collector(&actual);
+
+    for (EventReceiver* receiver : { stack.get(), static_cast<EventReceiver*>(&collector) })
+    {
+        receiver->note_on(0, 0, 60, 100);
+        receiver->note_on(10, 9, 60, 100);
+        receiver->control_change(5, 9, 7, 100);
+        receiver->note_on(5, 0, 60, 80);    // Repeated note on ends the first one
+        receiver->note_on(10, 9, 60, 0);    // Velocity 0 is a note off
+        receiver->note_off(3, 15, 60, 0);   // Nothing playing
+        receiver->meta(7, 0x01, "", 0);
+        receiver->note_off(1, 0, 60, 0);
+        receiver->pitch_wheel_change(2, 3, 0x2000);
+    }
+
+    CHECK(actual == expected);
+    CHECK(actual == std::vector<NOTE>{ NOTE{ 0, 60, 0, 20 }, NOTE{ 9, 60, 10, 20 }, NOTE{ 0, 60, 20, 21 } });
+}
+
+// Run with the [benchmark] tag to compare with the filter stack
+TEST_CASE("ChannelNoteCollector, benchmark", "[.][benchmark]")
+{
+    std::vector<MidiBuffer> buffers(sizeof(sample_names) / sizeof(sample_names[0]));
+    std::vector<ByteCursor> all_tracks;
+    std::vector<NOTE> notes;
+
+    for (size_t i = 0; i != buffers.size(); ++i)
+    {
+        buffers[i] = load_sample(sample_names[i]);
+
+        for (ByteCursor track : track_cursors(buffers[i]))
+        {
+            all_tracks.push_back(track);
+        }
+    }
+
+    BENCHMARK("16 NoteFilters, EventMulticaster")
+    {
+        for (int round = 0; round != 20; ++round)
+        {
+            for (ByteCursor track : all_tracks)
+            {
+                notes.clear();
+                auto stack = filter_stack(&notes);
+                read_mtrk(track, *stack);
+            }
+        }
+    }
+
+    BENCHMARK("ChannelNoteCollector, virtual calls")
+    {
+        for (int round = 0; round != 20; ++round)
+        {
+            for (ByteCursor track : all_tracks)
+            {
+                notes.clear();
+                ChannelNoteCollector collector(&notes);
+                read_mtrk(track, static_cast<EventReceiver&>(collector));
+            }
+        }
+    }
+
+    BENCHMARK("ChannelNoteCollector, direct calls")
+    {
+        for (int round = 0; round != 20; ++round)
+        {
+            for (ByteCursor track : all_tracks)
+            {
+                notes.clear();
+                ChannelNoteCollector collector(&notes);
+                read_mtrk(track, collector);
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,248 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "event-block.h"
+#include "static-receivers.h"
+#include "tests-util.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace testutils;
+
+
+/*
+    read_mtrk_blocks delivers the same events as read_mtrk, 256 at a time.
+    Going through an EventBlockAdapter must give an EventReceiver exactly
+    the calls it would have gotten from read_mtrk.
+*/
+
+
+namespace
+{
+    struct EventLogger
+    {
+        std::vector<std::string> events;
+
+        void log(const char* name, uint32_t dt, int a, int b = -1)
+        {
+            events.push_back(std::string(name) + " " + std::to_string(dt) + " " + std::to_string(a) + " " + std::to_string(b));
+        }
+
+        void note_on(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) { log("on", dt, channel * 128 + note, velocity); }
+        void note_off(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) { log("off", dt, channel * 128 + note, velocity); }
+        void polyphonic_key_pressure(uint32_t dt, uint8_t channel, uint8_t note, uint8_t pressure) { log("poly", dt, channel * 128 + note, pressure); }
+        void control_change(uint32_t dt, uint8_t channel, uint8_t controller, uint8_t value) { log("cc", dt, channel * 128 + controller, value); }
+        void program_change(uint32_t dt, uint8_t channel, uint8_t program) { log("program", dt, channel, program); }
+        void channel_pressure(uint32_t dt, uint8_t channel, uint8_t pressure) { log("pressure", dt, channel, pressure); }
+        void pitch_wheel_change(uint32_t dt, uint8_t channel, uint16_t value) { log("pitch", dt, channel, value); }
+        void meta(uint32_t dt, uint8_t type, const char* data, int data_size) { log("meta", dt, type, int(std::string(data, data_size).size())); }
+        void sysex(uint32_t dt, const char* data, int data_size) { log("sysex", dt, data_size); }
+    };
+
+    struct NoteLogger : EventLogger
+    {
+        bool wants_meta() const { return false; }
+        bool wants_sysex() const { return false; }
+    };
+
+    class BlockSizes : public EventBlockReceiver
+    {
+    public:
+        std::vector<size_t> sizes;
+        int tracks = 0;
+        bool saw_meta = false;
+        bool meta_wanted = true;
+
+        bool wants_meta() const override { return meta_wanted; }
+
+        void events(const EVENT_BLOCK& block) override
+        {
+            sizes.push_back(block.size);
+
+            for (size_t i = 0; i != block.size; ++i)
+            {
+                saw_meta = saw_meta || block.status[i] == 0xFF;
+            }
+        }
+
+        void end_track() override { ++tracks; }
+        void abort_track() override { ++aborted; }
+
+        int aborted = 0;
+    };
+
+}
+
+TEST_CASE("EventBlockAdapter reproduces the calls of read_mtrk")
+{
+    for (const char* name : sample_names)
+    {
+        INFO(name);
+
+        MidiBuffer buffer = load_sample(name);
+
+        EventLogger direct, blocked;
+        NoteLogger notes_direct, notes_blocked;
+        EventReceiverAdapter<EventLogger> receiver(blocked);
+        EventReceiverAdapter<NoteLogger> note_receiver(notes_blocked);
+        EventBlockAdapter adapter(receiver), note_adapter(note_receiver);
+
+        // One adapter for all tracks: dt must restart with every track
+        for (ByteCursor track : track_cursors(buffer))
+        {
+            ByteCursor copies[] = { track, track, track };
+
+            REQUIRE(read_mtrk(track, direct));
+            REQUIRE(read_mtrk(copies[0], notes_direct));
+            REQUIRE(read_mtrk_blocks(copies[1], adapter));
+            REQUIRE(read_mtrk_blocks(copies[2], note_adapter));
+            CHECK(copies[1].at_end());
+        }
+
+        CHECK(blocked.events == direct.events);
+        CHECK(notes_blocked.events == notes_direct.events);
+    }
+}
+
+TEST_CASE("read_mtrk_blocks, block sizes")
+{
+    MidiBuffer buffer = load_sample("10");
+    std::vector<ByteCursor> all_tracks = track_cursors(buffer);
+
+    BlockSizes sizes;
+    for (ByteCursor track : all_tracks)
+    {
+        REQUIRE(read_mtrk_blocks(track, sizes));
+    }
+
+    CHECK(sizes.tracks == int(all_tracks.size()));
+    CHECK(sizes.saw_meta);
+    REQUIRE(!sizes.sizes.empty());
+    CHECK(std::count(sizes.sizes.begin(), sizes.sizes.end(), EVENT_BLOCK::capacity) > 0);
+    for (size_t size : sizes.sizes)
+    {
+        CHECK(size > 0);
+        CHECK(size <= EVENT_BLOCK::capacity);
+    }
+
+    BlockSizes without_meta;
+    without_meta.meta_wanted = false;
+    for (ByteCursor track : all_tracks)
+    {
+        REQUIRE(read_mtrk_blocks(track, without_meta));
+    }
+    CHECK(!without_meta.saw_meta);
+}
+
+TEST_CASE("read_mtrk_blocks, truncated track fails")
+{
+    MidiBuffer buffer = load_sample("01");
+    ByteCursor track = track_cursors(buffer).back();
+    ByteCursor truncated(track.position(), track.remaining() - 1);
+    BlockSizes sizes;
+
+    CHECK(!read_mtrk_blocks(truncated, sizes));
+    CHECK(sizes.tracks == 0);
+    CHECK(sizes.aborted == 1);
+}
+
+TEST_CASE("read_mtrk_blocks, a good track after a broken one decodes as if alone")
+{
+    for (const char* name : sample_names)
+    {
+        INFO(name);
+
+        MidiBuffer buffer = load_sample(name);
+
+        for (ByteCursor track : track_cursors(buffer))
+        {
+            std::vector<NOTE> expected, actual;
+            EventLogger direct, blocked;
+            EventReceiverAdapter<EventLogger> receiver(blocked);
+            EventBlockAdapter adapter(receiver);
+            BlockNoteCollector collector(&actual);
+
+            ByteCursor copies[] = { track, track, track, track };
+            REQUIRE(read_track_notes(copies[0], &expected));
+            REQUIRE(read_mtrk(copies[1], direct));
+
+            // A chunk that ends in the middle of the events, so notes are left playing and time has moved on
+            uint32_t half = uint32_t(track.remaining() - 8) / 2;
+            std::vector<uint8_t> data(track.position(), track.position() + 8 + half);
+            data[4] = uint8_t(half >> 24);
+            data[5] = uint8_t(half >> 16);
+            data[6] = uint8_t(half >> 8);
+            data[7] = uint8_t(half);
+            ByteCursor broken[] = { ByteCursor(data.data(), data.size()), ByteCursor(data.data(), data.size()) };
+            CHECK(!read_mtrk_blocks(broken[0], collector));
+            CHECK(!read_mtrk_blocks(broken[1], adapter));
+            actual.clear();
+            blocked.events.clear();
+
+            REQUIRE(read_mtrk_blocks(copies[2], collector));
+            REQUIRE(read_mtrk_blocks(copies[3], adapter));
+            CHECK(actual == expected);
+            CHECK(blocked.events == direct.events);
+        }
+    }
+}
+
+TEST_CASE("BlockNoteCollector agrees with ChannelNoteCollector")
+{
+    for (const char* name : sample_names)
+    {
+        INFO(name);
+
+        MidiBuffer buffer = load_sample(name);
+
+        std::vector<NOTE> expected, actual;
+        BlockNoteCollector collector(&actual);
+
+        for (ByteCursor track : track_cursors(buffer))
+        {
+            ByteCursor copy = track;
+            REQUIRE(read_track_notes(track, &expected));
+            REQUIRE(read_mtrk_blocks(copy, collector));
+        }
+
+        CHECK(actual == expected);
+    }
+}
+
+TEST_CASE("ControllerStatistics counts events per kind")
+{
+    MidiBuffer buffer = load_sample("10");
+
+    EventLogger logger;
+    ControllerStatistics statistics;
+    for (ByteCursor track : track_cursors(buffer))
+    {
+        ByteCursor copy = track;
+        REQUIRE(read_mtrk(track, logger));
+        REQUIRE(read_mtrk_blocks(copy, statistics));
+    }
+
+    auto count = [&logger](const std::string& kind) {
+        return uint32_t(std::count_if(logger.events.begin(), logger.events.end(), [&kind](const std::string& e) { return e.compare(0, kind.size() + 1, kind + " ") == 0; }));
+    };
+
+    CHECK(statistics.counts_by_kind()[0x8] == count("off"));
+    CHECK(statistics.counts_by_kind()[0x9] == count("on"));
+    CHECK(statistics.counts_by_kind()[0xB] == count("cc"));
+    CHECK(statistics.counts_by_kind()[0xC] == count("program"));
+    CHECK(statistics.counts_by_kind()[0xF] == 0);
+
+    uint32_t control_changes = 0;
+    for (uint8_t channel = 0; channel != 16; ++channel)
+    {
+        for (uint8_t controller = 0; controller != 128; ++controller)
+        {
+            control_changes += statistics.control_changes(channel, controller);
+        }
+    }
+    CHECK(control_changes == count("cc"));
+}
+
+#endif
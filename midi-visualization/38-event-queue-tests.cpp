@@ -0,0 +1,282 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "event-queue.h"
+#include "static-receivers.h"
+#include "tests-util.h"
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace testutils;
+
+
+/*
+    SpscQueue moves items from one thread to another in order, and makes the
+    producer wait when it is full. QueueingReceiver and DrainingSource use it to
+    run a receiver on another thread than read_mtrk; the receiver must get exactly
+    the calls it would have gotten directly.
+*/
+
+
+namespace
+{
+    struct EventLogger
+    {
+        std::vector<std::string> events;
+
+        void log(const char* name, uint32_t dt, int a, int b = -1)
+        {
+            events.push_back(std::string(name) + " " + std::to_string(dt) + " " + std::to_string(a) + " " + std::to_string(b));
+        }
+
+        void note_on(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) { log("on", dt, channel * 128 + note, velocity); }
+        void note_off(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) { log("off", dt, channel * 128 + note, velocity); }
+        void polyphonic_key_pressure(uint32_t dt, uint8_t channel, uint8_t note, uint8_t pressure) { log("poly", dt, channel * 128 + note, pressure); }
+        void control_change(uint32_t dt, uint8_t channel, uint8_t controller, uint8_t value) { log("cc", dt, channel * 128 + controller, value); }
+        void program_change(uint32_t dt, uint8_t channel, uint8_t program) { log("program", dt, channel, program); }
+        void channel_pressure(uint32_t dt, uint8_t channel, uint8_t pressure) { log("pressure", dt, channel, pressure); }
+        void pitch_wheel_change(uint32_t dt, uint8_t channel, uint16_t value) { log("pitch", dt, channel, value); }
+        void meta(uint32_t dt, uint8_t type, const char* data, int data_size) { events.push_back("meta " + std::to_string(dt) + " " + std::to_string(type) + " " + std::string(data, data_size)); }
+        void sysex(uint32_t dt, const char* data, int data_size) { events.push_back("sysex " + std::to_string(dt) + " " + std::string(data, data_size)); }
+    };
+
+}
+
+TEST_CASE("SpscQueue, single thread")
+{
+    SpscQueue<int> queue(5);
+    REQUIRE(queue.capacity() == 8);
+
+    int x;
+    CHECK(!queue.try_pop(&x));
+
+    for (int round = 0; round != 3; ++round)
+    {
+        for (int i = 0; i != 8; ++i)
+        {
+            CHECK(queue.try_push(round * 10 + i));
+        }
+        CHECK(!queue.try_push(99));
+
+        for (int i = 0; i != 8; ++i)
+        {
+            REQUIRE(queue.try_pop(&x));
+            CHECK(x == round * 10 + i);
+        }
+        CHECK(!queue.try_pop(&x));
+    }
+}
+
+TEST_CASE("SpscQueue, bulk operations wrap around")
+{
+    SpscQueue<int> queue(8);
+    int in[6] = { 1, 2, 3, 4, 5, 6 };
+    int out[6];
+
+    CHECK(queue.try_push(in, 6) == 6);
+    CHECK(queue.try_pop(out, 4) == 4);
+    CHECK(queue.try_push(in, 6) == 6);
+    CHECK(queue.try_push(in, 6) == 0);
+    CHECK(queue.try_pop(out, 6) == 6);
+    CHECK(std::vector<int>(out, out + 6) == std::vector<int>{ 5, 6, 1, 2, 3, 4 });
+    CHECK(queue.try_pop(out, 6) == 2);
+}
+
+TEST_CASE("SpscQueue, two threads")
+{
+    const int count = 200000;
+    SpscQueue<int> queue(64);
+    std::vector<int> received;
+    received.reserve(count);
+
+    std::thread consumer([&]() {
+        int x;
+        for (int i = 0; i != count; ++i)
+        {
+            queue.pop(&x);
+            received.push_back(x);
+        }
+    });
+
+    for (int i = 0; i != count; ++i)
+    {
+        queue.push(i);
+    }
+    consumer.join();
+
+    std::vector<int> expected(count);
+    std::iota(expected.begin(), expected.end(), 0);
+    CHECK(received == expected);
+}
+
+TEST_CASE("QueueingReceiver and DrainingSource pass on every event")
+{
+    for (const char* name : { "01", "05", "10", "harmonies" })
+    {
+        INFO(name);
+
+        MidiBuffer buffer = load_sample(name);
+        std::vector<ByteCursor> all_tracks = track_cursors(buffer);
+
+        EventLogger direct;
+        for (ByteCursor track : all_tracks)
+        {
+            REQUIRE(read_mtrk(track, direct));
+        }
+
+        // Small queues, so that the decoder has to wait for the consumer and payloads come in pieces
+        EventQueue queue(16, 4);
+        EventLogger queued;
+        EventReceiverAdapter<EventLogger> receiver(queued);
+        QueueingReceiver producer(queue, receiver);
+        DrainingSource consumer(queue);
+
+        std::thread decoder([&]() {
+            for (ByteCursor track : all_tracks)
+            {
+                read_mtrk(track, producer);
+            }
+            producer.finish();
+        });
+
+        consumer.drain(receiver);
+        decoder.join();
+
+        CHECK(consumer.finished());
+        CHECK(queued.events == direct.events);
+    }
+}
+
+TEST_CASE("QueueingReceiver, notes collected on another thread")
+{
+    MidiBuffer buffer = load_sample("10");
+    std::vector<ByteCursor> all_tracks = track_cursors(buffer);
+
+    for (ByteCursor track : all_tracks)
+    {
+        std::vector<NOTE> expected, actual;
+        ByteCursor copy = track;
+        REQUIRE(read_track_notes(copy, &expected));
+
+        EventQueue queue(256);
+        ChannelNoteCollector collector(&actual);
+        QueueingReceiver producer(queue, collector);
+        DrainingSource consumer(queue);
+
+        CHECK(!producer.wants_meta());
+
+        std::thread decoder([&]() {
+            read_mtrk(track, producer);
+            producer.finish();
+        });
+        consumer.drain(collector);
+        decoder.join();
+
+        CHECK(actual == expected);
+    }
+}
+
+TEST_CASE("DrainingSource, drain_available does not wait")
+{
+    EventQueue queue(8);
+    QueueingReceiver producer(queue);
+    DrainingSource consumer(queue);
+    EventLogger logger;
+    EventReceiverAdapter<EventLogger> receiver(logger);
+
+    CHECK(consumer.drain_available(receiver, 10) == 0);
+
+    producer.note_on(1, 2, 3, 4);
+    producer.meta(5, 0x03, "name", 4);
+    producer.pitch_wheel_change(6, 1, 0x1234);
+    CHECK(consumer.drain_available(receiver, 2) == 2);
+    CHECK(consumer.drain_available(receiver, 10) == 1);
+
+    producer.finish();
+    CHECK(consumer.drain_available(receiver, 10) == 0);
+    CHECK(consumer.finished());
+    CHECK(logger.events == std::vector<std::string>{ "on 1 259 4", "meta 5 3 name", "pitch 6 1 4660" });
+}
+
+TEST_CASE("DrainingSource, drain_available holds back an event until its payload is there")
+{
+    EventQueue queue(8);
+    DrainingSource consumer(queue);
+    EventLogger logger;
+    EventReceiverAdapter<EventLogger> receiver(logger);
+
+    // The event is in the queue before its payload, as QueueingReceiver::meta sends them
+    queue.events.push(QUEUED_EVENT{ 5, 4, 0xFF, 0x03, 0 });
+    CHECK(consumer.drain_available(receiver, 10) == 0);
+
+    queue.payload.push(reinterpret_cast<const uint8_t*>("na"), 2);
+    CHECK(consumer.drain_available(receiver, 10) == 0);
+    CHECK(logger.events.empty());
+
+    queue.payload.push(reinterpret_cast<const uint8_t*>("me"), 2);
+    CHECK(consumer.drain_available(receiver, 10) == 1);
+    CHECK(logger.events == std::vector<std::string>{ "meta 5 3 name" });
+}
+
+TEST_CASE("DrainingSource, polling on another thread with payloads in pieces")
+{
+    MidiBuffer buffer = load_sample("harmonies");
+    std::vector<ByteCursor> all_tracks = track_cursors(buffer);
+
+    EventLogger direct;
+    for (ByteCursor track : all_tracks)
+    {
+        REQUIRE(read_mtrk(track, direct));
+    }
+
+    EventQueue queue(16, 4);
+    EventLogger queued;
+    EventReceiverAdapter<EventLogger> receiver(queued);
+    QueueingReceiver producer(queue, receiver);
+    DrainingSource consumer(queue);
+
+    std::thread decoder([&]() {
+        for (ByteCursor track : all_tracks)
+        {
+            read_mtrk(track, producer);
+        }
+        producer.finish();
+    });
+
+    while (!consumer.finished())
+    {
+        consumer.drain_available(receiver, 3);
+    }
+    decoder.join();
+
+    CHECK(queued.events == direct.events);
+}
+
+TEST_CASE("DrainingSource, reset reads the next stream")
+{
+    EventQueue queue(8);
+    QueueingReceiver producer(queue);
+    DrainingSource consumer(queue);
+    EventLogger logger;
+    EventReceiverAdapter<EventLogger> receiver(logger);
+
+    producer.note_on(1, 2, 3, 4);
+    producer.finish();
+    producer.note_off(7, 2, 3, 0);
+    producer.finish();
+
+    consumer.drain(receiver);
+    CHECK(consumer.finished());
+    CHECK(consumer.drain_available(receiver, 10) == 0);
+
+    consumer.reset();
+    CHECK(!consumer.finished());
+    consumer.drain(receiver);
+    CHECK(consumer.finished());
+    CHECK(logger.events == std::vector<std::string>{ "on 1 259 4", "off 7 259 0" });
+}
+
+#endif
@@ -0,0 +1,176 @@
+#include "settings.h"
+
+#ifdef TEST_BUILD
+
+#include "parallel-multicaster.h"
+#include "static-receivers.h"
+#include "tests-util.h"
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace testutils;
+
+
+/*
+    ParallelEventMulticaster runs every receiver on its own thread.
+    Each receiver must still get exactly the calls EventMulticaster would give it,
+    in the same order.
+*/
+
+
+namespace
+{
+    class EventLogger : public EventReceiver
+    {
+    public:
+        std::vector<std::string> events;
+        bool meta_wanted = true;
+
+        bool wants_meta() const override { return meta_wanted; }
+
+        void log(const char* name, uint32_t dt, int a, int b = -1)
+        {
+            events.push_back(std::string(name) + " " + std::to_string(dt) + " " + std::to_string(a) + " " + std::to_string(b));
+        }
+
+        void note_on(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) override { log("on", dt, channel * 128 + note, velocity); }
+        void note_off(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) override { log("off", dt, channel * 128 + note, velocity); }
+        void polyphonic_key_pressure(uint32_t dt, uint8_t channel, uint8_t note, uint8_t pressure) override { log("poly", dt, channel * 128 + note, pressure); }
+        void control_change(uint32_t dt, uint8_t channel, uint8_t controller, uint8_t value) override { log("cc", dt, channel * 128 + controller, value); }
+        void program_change(uint32_t dt, uint8_t channel, uint8_t program) override { log("program", dt, channel, program); }
+        void channel_pressure(uint32_t dt, uint8_t channel, uint8_t pressure) override { log("pressure", dt, channel, pressure); }
+        void pitch_wheel_change(uint32_t dt, uint8_t channel, uint16_t value) override { log("pitch", dt, channel, value); }
+        void meta(uint32_t dt, uint8_t type, const char* data, int data_size) override { events.push_back("meta " + std::to_string(dt) + " " + std::to_string(type) + " " + std::string(data, data_size)); }
+        void sysex(uint32_t dt, const char* data, int data_size) override { events.push_back("sysex " + std::to_string(dt) + " " + std::string(data, data_size)); }
+    };
+
+    // 16 NoteFilters, each with a vector of its own, plus two loggers
+    struct Receivers
+    {
+        std::vector<std::vector<NOTE>> notes = std::vector<std::vector<NOTE>>(16);
+        std::vector<std::shared_ptr<EventReceiver>> all;
+        std::shared_ptr<EventLogger> logger = std::make_shared<EventLogger>();
+        std::shared_ptr<EventLogger> note_logger = std::make_shared<EventLogger>();
+
+        Receivers()
+        {
+            note_logger->meta_wanted = false;
+
+            for (uint8_t channel = 0; channel != 16; ++channel)
+            {
+                all.push_back(std::make_shared<NoteFilter>(channel, &notes[channel]));
+            }
+            all.push_back(logger);
+            all.push_back(note_logger);
+        }
+    };
+}
+
+TEST_CASE("ParallelEventMulticaster gives every receiver the calls of EventMulticaster")
+{
+    for (const char* name : { "01", "05", "10", "harmonies", "lengths" })
+    {
+        MidiBuffer buffer = load_sample(name);
+        std::vector<ByteCursor> all_tracks = track_cursors(buffer);
+
+        Receivers expected;
+        EventMulticaster sequential(expected.all);
+        for (ByteCursor track : all_tracks)
+        {
+            REQUIRE(read_mtrk(track, sequential));
+        }
+
+        // Tiny blocks and a short ring make the decoder wait for the workers all the time
+        for (size_t block_size : { size_t(1), size_t(7), size_t(256) })
+        {
+            INFO(name << ", block size " << block_size);
+
+            Receivers actual;
+            {
+                ParallelEventMulticaster parallel(actual.all, block_size, 2);
+                CHECK(parallel.wants_meta());
+
+                for (ByteCursor track : all_tracks)
+                {
+                    REQUIRE(read_mtrk(track, parallel));
+                }
+                parallel.wait();
+
+                CHECK(actual.logger->events == expected.logger->events);
+            }
+
+            CHECK(actual.notes == expected.notes);
+            CHECK(actual.note_logger->events == expected.note_logger->events);
+        }
+    }
+}
+
+TEST_CASE("ParallelEventMulticaster, wait in between")
+{
+    auto logger = std::make_shared<EventLogger>();
+    ParallelEventMulticaster parallel({ logger }, 4, 3);
+
+    parallel.note_on(1, 0, 60, 100);
+    parallel.meta(2, 0x01, "text", 4);
+    parallel.wait();
+    CHECK(logger->events == std::vector<std::string>{ "on 1 60 100", "meta 2 1 text" });
+
+    for (int i = 0; i != 100; ++i)
+    {
+        parallel.control_change(uint32_t(i), 1, 7, uint8_t(i));
+    }
+    parallel.sysex(3, "xyz", 3);
+    parallel.wait();
+
+    REQUIRE(logger->events.size() == 103);
+    CHECK(logger->events[101] == "cc 99 135 99");
+    CHECK(logger->events[102] == "sysex 3 xyz");
+}
+
+TEST_CASE("ParallelEventMulticaster, sleeping workers and decoder are woken up")
+{
+    class SlowLogger : public EventLogger
+    {
+    public:
+        void note_on(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) override
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            EventLogger::note_on(dt, channel, note, velocity);
+        }
+    };
+
+    auto slow = std::make_shared<SlowLogger>();
+    auto fast = std::make_shared<EventLogger>();
+    ParallelEventMulticaster parallel({ slow, fast }, 2, 2);
+
+    // Long enough for both workers to go to sleep
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    // Only two blocks of two events, so the slow receiver holds the decoder back
+    for (int i = 0; i != 20; ++i)
+    {
+        parallel.note_on(uint32_t(i), 0, 60, 100);
+    }
+    parallel.wait();
+    CHECK(slow->events.size() == 20);
+    CHECK(fast->events.size() == 20);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    parallel.note_off(5, 0, 60, 0);
+    parallel.wait();
+    CHECK(slow->events.back() == "off 5 60 0");
+    CHECK(fast->events.back() == "off 5 60 0");
+}
+
+TEST_CASE("ParallelEventMulticaster, without receivers")
+{
+    ParallelEventMulticaster parallel({});
+
+    CHECK(!parallel.wants_meta());
+    parallel.note_on(0, 0, 1, 1);
+    parallel.wait();
+}
+
+#endif
@@ -0,0 +1,238 @@
+#include "midi.h"
+
+
+NoteFilter::NoteFilter(uint8_t channel, std::vector<NOTE>* notes)
+	: m_channel(channel)
+	, m_notes(notes)
+	, m_time(0)
+{
+	for (int i = 0; i != 128; ++i)
+	{
+		m_start[i] = 0;
+		m_playing[i] = false;
+	}
+}
+
+void NoteFilter::end_note(uint8_t note)
+{
+	if (m_playing[note])
+	{
+		m_notes->push_back(NOTE{ m_channel, note, m_start[note], m_time - m_start[note] });
+		m_playing[note] = false;
+	}
+}
+
+void NoteFilter::note_on(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity)
+{
+	m_time += dt;
+
+	if (channel == m_channel)
+	{
+		note &= 0x7F;
+
+		// A note on with velocity 0 counts as a note off; a repeated note on ends the previous one
+		end_note(note);
+
+		if (velocity != 0)
+		{
+			m_start[note] = m_time;
+			m_playing[note] = true;
+		}
+	}
+}
+
+void NoteFilter::note_off(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity)
+{
+	m_time += dt;
+
+	if (channel == m_channel)
+	{
+		end_note(note & 0x7F);
+	}
+}
+
+void NoteFilter::polyphonic_key_pressure(uint32_t dt, uint8_t channel, uint8_t note, uint8_t pressure)
+{
+	m_time += dt;
+}
+
+void NoteFilter::control_change(uint32_t dt, uint8_t channel, uint8_t controller, uint8_t value)
+{
+	m_time += dt;
+}
+
+void NoteFilter::program_change(uint32_t dt, uint8_t channel, uint8_t program)
+{
+	m_time += dt;
+}
+
+void NoteFilter::channel_pressure(uint32_t dt, uint8_t channel, uint8_t pressure)
+{
+	m_time += dt;
+}
+
+void NoteFilter::pitch_wheel_change(uint32_t dt, uint8_t channel, uint16_t value)
+{
+	m_time += dt;
+}
+
+void NoteFilter::meta(uint32_t dt, uint8_t type, const char* data, int data_size)
+{
+	m_time += dt;
+}
+
+void NoteFilter::sysex(uint32_t dt, const char* data, int data_size)
+{
+	m_time += dt;
+}
+
+
+ChannelNoteCollector::ChannelNoteCollector(std::vector<NOTE>* notes)
+	: m_notes(notes)
+	, m_time(0)
+{
+	for (int channel = 0; channel != 16; ++channel)
+	{
+		for (int i = 0; i != 128; ++i)
+		{
+			m_start[channel][i] = 0;
+			m_playing[channel][i] = false;
+		}
+	}
+}
+
+void ChannelNoteCollector::end_note(uint8_t channel, uint8_t note)
+{
+	if (m_playing[channel][note])
+	{
+		m_notes->push_back(NOTE{ channel, note, m_start[channel][note], m_time - m_start[channel][note] });
+		m_playing[channel][note] = false;
+	}
+}
+
+void ChannelNoteCollector::note_on(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity)
+{
+	m_time += dt;
+	channel &= 0x0F;
+	note &= 0x7F;
+
+	// Same rules as NoteFilter: velocity 0 is a note off, a repeated note on ends the previous one
+	end_note(channel, note);
+
+	if (velocity != 0)
+	{
+		m_start[channel][note] = m_time;
+		m_playing[channel][note] = true;
+	}
+}
+
+void ChannelNoteCollector::note_off(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity)
+{
+	m_time += dt;
+	end_note(channel & 0x0F, note & 0x7F);
+}
+
+
+EventMulticaster::EventMulticaster(const std::vector<std::shared_ptr<EventReceiver>>& receivers)
+	: m_receivers(receivers)
+{
+	// NOP
+}
+
+bool EventMulticaster::wants_meta() const
+{
+	for (auto& receiver : m_receivers)
+	{
+		if (receiver->wants_meta())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool EventMulticaster::wants_sysex() const
+{
+	for (auto& receiver : m_receivers)
+	{
+		if (receiver->wants_sysex())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void EventMulticaster::note_on(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity)
+{
+	for (auto& receiver : m_receivers)
+	{
+		receiver->note_on(dt, channel, note, velocity);
+	}
+}
+
+void EventMulticaster::note_off(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity)
+{
+	for (auto& receiver : m_receivers)
+	{
+		receiver->note_off(dt, channel, note, velocity);
+	}
+}
+
+void EventMulticaster::polyphonic_key_pressure(uint32_t dt, uint8_t channel, uint8_t note, uint8_t pressure)
+{
+	for (auto& receiver : m_receivers)
+	{
+		receiver->polyphonic_key_pressure(dt, channel, note, pressure);
+	}
+}
+
+void EventMulticaster::control_change(uint32_t dt, uint8_t channel, uint8_t controller, uint8_t value)
+{
+	for (auto& receiver : m_receivers)
+	{
+		receiver->control_change(dt, channel, controller, value);
+	}
+}
+
+void EventMulticaster::program_change(uint32_t dt, uint8_t channel, uint8_t program)
+{
+	for (auto& receiver : m_receivers)
+	{
+		receiver->program_change(dt, channel, program);
+	}
+}
+
+void EventMulticaster::channel_pressure(uint32_t dt, uint8_t channel, uint8_t pressure)
+{
+	for (auto& receiver : m_receivers)
+	{
+		receiver->channel_pressure(dt, channel, pressure);
+	}
+}
+
+void EventMulticaster::pitch_wheel_change(uint32_t dt, uint8_t channel, uint16_t value)
+{
+	for (auto& receiver : m_receivers)
+	{
+		receiver->pitch_wheel_change(dt, channel, value);
+	}
+}
+
+void EventMulticaster::meta(uint32_t dt, uint8_t type, const char* data, int data_size)
+{
+	for (auto& receiver : m_receivers)
+	{
+		receiver->meta(dt, type, data, data_size);
+	}
+}
+
+void EventMulticaster::sysex(uint32_t dt, const char* data, int data_size)
+{
+	for (auto& receiver : m_receivers)
+	{
+		receiver->sysex(dt, data, data_size);
+	}
+}
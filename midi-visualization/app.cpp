@@ -6,12 +6,53 @@
 
 #ifndef TEST_BUILD
 
+#include "batch-ingest.h"
+#include "command-line-parser.h"
 #include <iostream>
 
 
+/*
+    Batch mode:
+
+        midi-visualization --batch <directory or file> [--batch ...] [--threads n] [--split bytes]
+
+    reads every MIDI file that was given (directly or inside one of the directories)
+    in parallel and reports the throughput.
+*/
 int main(int argn, char** argv)
 {
-    std::cout << "Hello world!" << std::endl;
+    std::vector<std::string> paths;
+    BATCH_OPTIONS options;
+    CommandLineParser parser;
+
+    parser.register_processor("--batch", std::function<void(const std::string&)>([&paths](const std::string& path) {
+        if (!list_midi_files(path, &paths))
+        {
+            std::cerr << "Could not read directory " << path << std::endl;
+        }
+    }));
+    parser.register_processor("--threads", std::function<void(int)>([&options](int count) {
+        options.thread_count = unsigned(count);
+    }));
+    parser.register_processor("--split", std::function<void(int)>([&options](int bytes) {
+        options.split_threshold = size_t(bytes);
+    }));
+
+    parser.process(argn, argv);
+
+    if (paths.empty())
+    {
+        std::cerr << "Usage: " << argv[0] << " --batch <directory or file> [--batch ...] [--threads n] [--split bytes]" << std::endl;
+        return 1;
+    }
+
+    BATCH_STATISTICS statistics = process_files(paths, options, NoteConsumer());
+
+    std::cout << statistics.files << " files (" << statistics.failed << " failed), "
+              << statistics.notes << " notes, " << statistics.bytes << " bytes in " << statistics.seconds << " s" << std::endl;
+    std::cout << statistics.files_per_second() << " files/s, " << statistics.megabytes_per_second() << " MB/s" << std::endl;
+
+    return statistics.failed == 0 ? 0 : 1;
 }
 
 #endif
@@ -0,0 +1,83 @@
+#include "arena.h"
+#include <algorithm>
+
+
+Arena::Arena(size_t initial_block_size)
+	: m_used_in_full_blocks(0)
+	, m_position(nullptr)
+	, m_end(nullptr)
+{
+	add_block(initial_block_size);
+}
+
+void Arena::add_block(size_t minimum_size)
+{
+	size_t size = m_blocks.empty() ? minimum_size : std::max(minimum_size, 2 * m_blocks.back().size);
+
+	if (!m_blocks.empty())
+	{
+		m_used_in_full_blocks += size_t(m_position - m_blocks.back().memory.get());
+	}
+
+	m_blocks.push_back(BLOCK{ std::unique_ptr<uint8_t[]>(new uint8_t[size]), size });
+	m_position = m_blocks.back().memory.get();
+	m_end = m_position + size;
+}
+
+void* Arena::allocate(size_t size, size_t alignment)
+{
+	uintptr_t position = reinterpret_cast<uintptr_t>(m_position);
+	size_t padding = (alignment - position % alignment) % alignment;
+
+	if (size + padding > size_t(m_end - m_position))
+	{
+		// A fresh block is aligned for anything, so no padding is needed there
+		add_block(size);
+		padding = 0;
+	}
+
+	uint8_t* result = m_position + padding;
+	m_position = result + size;
+
+	return result;
+}
+
+void Arena::deallocate(void* p, size_t size)
+{
+	if (static_cast<uint8_t*>(p) + size == m_position)
+	{
+		m_position = static_cast<uint8_t*>(p);
+	}
+}
+
+void Arena::reset()
+{
+	if (m_blocks.size() > 1)
+	{
+		size_t total = bytes_reserved();
+
+		m_blocks.clear();
+		add_block(total);
+	}
+
+	m_used_in_full_blocks = 0;
+	m_position = m_blocks.back().memory.get();
+	m_end = m_position + m_blocks.back().size;
+}
+
+size_t Arena::bytes_used() const
+{
+	return m_used_in_full_blocks + size_t(m_position - m_blocks.back().memory.get());
+}
+
+size_t Arena::bytes_reserved() const
+{
+	size_t total = 0;
+
+	for (auto& block : m_blocks)
+	{
+		total += block.size;
+	}
+
+	return total;
+}
@@ -0,0 +1,96 @@
+#ifndef ARENA_H
+#define ARENA_H
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+/*
+	Bump allocator: allocate() hands out the next piece of the current block
+	and individual allocations are never freed. reset() makes all memory
+	available again in one go.
+
+	When an allocation does not fit, a new block is added (at least twice as big
+	as the previous one). reset() replaces several blocks by a single one as big
+	as all of them together, so after the first few uses the arena settles on
+	one block and stops calling the system allocator altogether.
+*/
+class Arena
+{
+public:
+	explicit Arena(size_t initial_block_size = 64 * 1024);
+
+	Arena(const Arena&) = delete;
+	Arena& operator =(const Arena&) = delete;
+
+	void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+	// Gives back the most recent allocation, if p is that allocation; otherwise does nothing.
+	void deallocate(void* p, size_t size);
+
+	void reset();
+
+	size_t bytes_used() const;
+	size_t bytes_reserved() const;
+
+private:
+	struct BLOCK
+	{
+		std::unique_ptr<uint8_t[]> memory;
+		size_t size;
+	};
+
+	void add_block(size_t minimum_size);
+
+	std::vector<BLOCK> m_blocks;
+	size_t m_used_in_full_blocks;
+	uint8_t* m_position;
+	uint8_t* m_end;
+};
+
+
+/*
+	Standard allocator on top of an Arena, so containers can allocate from it:
+
+		std::vector<NOTE, ArenaAllocator<NOTE>> notes(ArenaAllocator<NOTE>(arena));
+
+	The containers must not outlive the arena's next reset().
+*/
+template<typename T>
+class ArenaAllocator
+{
+public:
+	typedef T value_type;
+
+	ArenaAllocator(Arena& arena) : m_arena(&arena) { }
+
+	template<typename U>
+	ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.arena()) { }
+
+	T* allocate(size_t n)
+	{
+		return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* p, size_t n)
+	{
+		m_arena->deallocate(p, n * sizeof(T));
+	}
+
+	Arena* arena() const { return m_arena; }
+
+private:
+	Arena* m_arena;
+};
+
+template<typename T, typename U>
+bool operator ==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena() == b.arena(); }
+
+template<typename T, typename U>
+bool operator !=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena() != b.arena(); }
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif
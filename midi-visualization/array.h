@@ -33,6 +33,15 @@ public:
         , m_start(arr.m_start)
         , m_size(arr.m_size) { }
 
+    array<T>& operator =(const array<T>& arr)
+    {
+        m_data = arr.m_data;
+        m_start = arr.m_start;
+        m_size = arr.m_size;
+
+        return *this;
+    }
+
     T* ptr() { return m_data.get() + m_start; }
     const T* ptr() const { return m_data.get() + m_start; }
 
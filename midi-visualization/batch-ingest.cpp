@@ -0,0 +1,282 @@
+#include "batch-ingest.h"
+#include "midi-buffer.h"
+#include "parse-context.h"
+#include "chunk-index.h"
+#include "work-stealing-pool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+
+namespace
+{
+	struct COUNTERS
+	{
+		std::atomic<size_t> files;
+		std::atomic<size_t> failed;
+		std::atomic<uint64_t> bytes;
+		std::atomic<uint64_t> notes;
+	};
+
+	// A file whose tracks are decoded by separate tasks; the last task to finish puts the notes together.
+	struct SplitFile
+	{
+		std::string path;
+		MidiBuffer buffer; // Owns the bytes (read or mapped) rather than a ParseContext, whose next reset the tasks outlive
+		ChunkIndex index;
+		std::vector<std::vector<NOTE>> track_notes;
+		std::vector<char> succeeded;
+		std::atomic<size_t> remaining;
+	};
+
+	// Size of a file without opening it; false if it cannot be found
+	bool file_size(const std::string& path, uint64_t* size)
+	{
+#ifdef _WIN32
+		WIN32_FILE_ATTRIBUTE_DATA attributes;
+
+		if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &attributes))
+		{
+			return false;
+		}
+
+		*size = (uint64_t(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+#else
+		struct stat info;
+
+		if (stat(path.c_str(), &info) != 0)
+		{
+			return false;
+		}
+
+		*size = uint64_t(info.st_size);
+#endif
+		return true;
+	}
+
+	void finish_file(const std::string& path, bool ok, size_t size, const NOTE* notes, size_t count, COUNTERS& counters, const NoteConsumer& consumer)
+	{
+		++counters.files;
+
+		if (!ok)
+		{
+			++counters.failed;
+			return;
+		}
+
+		counters.bytes += size;
+		counters.notes += count;
+
+		if (consumer)
+		{
+			consumer(path, notes, count);
+		}
+	}
+
+	void finish_split_file(SplitFile& file, COUNTERS& counters, const NoteConsumer& consumer)
+	{
+		bool ok = std::all_of(file.succeeded.begin(), file.succeeded.end(), [](char succeeded) { return succeeded != 0; });
+		std::vector<NOTE> notes;
+
+		if (ok)
+		{
+			size_t total = 0;
+			for (auto& part : file.track_notes)
+			{
+				total += part.size();
+			}
+
+			notes.reserve(total);
+			for (auto& part : file.track_notes)
+			{
+				notes.insert(notes.end(), part.begin(), part.end());
+			}
+		}
+
+		finish_file(file.path, ok, file.buffer.size(), notes.data(), notes.size(), counters, consumer);
+	}
+
+	// Decodes the tracks of a format 1 file in tasks of their own
+	void split_file(WorkStealingPool& pool, const std::string& path, MidiBuffer&& buffer, const MThd& mthd, COUNTERS& counters, const NoteConsumer& consumer)
+	{
+		std::shared_ptr<SplitFile> file = std::make_shared<SplitFile>();
+		file->path = path;
+		file->buffer = std::move(buffer);
+
+		if (!file->index.build(file->buffer) || file->index.track_count() < mthd.ntracks)
+		{
+			finish_file(path, false, 0, nullptr, 0, counters, consumer);
+			return;
+		}
+
+		file->track_notes.resize(mthd.ntracks);
+		file->succeeded.resize(mthd.ntracks, 0);
+		file->remaining = mthd.ntracks;
+
+		for (size_t i = 0; i != mthd.ntracks; ++i)
+		{
+			pool.submit([file, i, &counters, &consumer]() {
+				ByteCursor track = file->index.track(i);
+				file->succeeded[i] = read_track_notes_fast(track, &file->track_notes[i]);
+
+				if (--file->remaining == 0)
+				{
+					finish_split_file(*file, counters, consumer);
+				}
+			});
+		}
+	}
+
+	void process_file(WorkStealingPool& pool, const std::string& path, const BATCH_OPTIONS& options, COUNTERS& counters, const NoteConsumer& consumer)
+	{
+		static thread_local ParseContext context;
+		uint64_t size;
+
+		// Small files are read straight into the arena; large ones are opened (or mapped) by a MidiBuffer of their own,
+		// which either moves into a SplitFile or is handed to the context without copying
+		if (!file_size(path, &size) || size < options.split_threshold)
+		{
+			if (!context.load(path))
+			{
+				finish_file(path, false, 0, nullptr, 0, counters, consumer);
+				return;
+			}
+		}
+		else
+		{
+			MidiBuffer buffer;
+
+			if (!buffer.open(path))
+			{
+				finish_file(path, false, 0, nullptr, 0, counters, consumer);
+				return;
+			}
+
+			ByteCursor cursor = buffer.cursor();
+			MThd mthd;
+
+			if (read_mthd(cursor, &mthd) && mthd.type == 1 && mthd.ntracks > 1)
+			{
+				split_file(pool, path, std::move(buffer), mthd, counters, consumer);
+				return;
+			}
+
+			context.use(std::move(buffer));
+		}
+
+		bool ok = context.read_notes();
+		finish_file(path, ok, context.buffer().size(), context.notes().data(), context.notes().size(), counters, consumer);
+	}
+}
+
+
+BATCH_STATISTICS process_files(const std::vector<std::string>& paths, const BATCH_OPTIONS& options, const NoteConsumer& consumer)
+{
+	COUNTERS counters;
+	counters.files = 0;
+	counters.failed = 0;
+	counters.bytes = 0;
+	counters.notes = 0;
+
+	auto start = std::chrono::steady_clock::now();
+
+	{
+		WorkStealingPool pool(options.thread_count);
+
+		for (auto& path : paths)
+		{
+			pool.submit([&pool, &path, &options, &counters, &consumer]() {
+				process_file(pool, path, options, counters, consumer);
+			});
+		}
+
+		pool.wait();
+	}
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	return BATCH_STATISTICS{ counters.files, counters.failed, counters.bytes, counters.notes, elapsed.count() };
+}
+
+bool list_midi_files(const std::string& path, std::vector<std::string>* paths)
+{
+	std::vector<std::string> names;
+
+#ifdef _WIN32
+	DWORD attributes = GetFileAttributesA(path.c_str());
+
+	if (attributes == INVALID_FILE_ATTRIBUTES || !(attributes & FILE_ATTRIBUTE_DIRECTORY))
+	{
+		paths->push_back(path);
+		return true;
+	}
+
+	WIN32_FIND_DATAA entry;
+	HANDLE search = FindFirstFileA((path + "\\*").c_str(), &entry);
+
+	if (search == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	do
+	{
+		if (!(entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+		{
+			names.push_back(entry.cFileName);
+		}
+	} while (FindNextFileA(search, &entry));
+
+	FindClose(search);
+	const char separator = '\\';
+#else
+	struct stat info;
+
+	if (stat(path.c_str(), &info) != 0 || !S_ISDIR(info.st_mode))
+	{
+		paths->push_back(path);
+		return true;
+	}
+
+	DIR* directory = opendir(path.c_str());
+
+	if (directory == nullptr)
+	{
+		return false;
+	}
+
+	while (dirent* entry = readdir(directory))
+	{
+		names.push_back(entry->d_name);
+	}
+
+	closedir(directory);
+	const char separator = '/';
+#endif
+
+	auto has_extension = [](const std::string& name, const std::string& extension) {
+		return name.size() > extension.size() && name.compare(name.size() - extension.size(), extension.size(), extension) == 0;
+	};
+
+	std::sort(names.begin(), names.end());
+
+	for (auto& name : names)
+	{
+		if (has_extension(name, ".mid") || has_extension(name, ".midi"))
+		{
+			paths->push_back(path + separator + name);
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,61 @@
+#ifndef BATCH_INGEST_H
+#define BATCH_INGEST_H
+#include "midi.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+struct BATCH_OPTIONS
+{
+	BATCH_OPTIONS() : thread_count(0), split_threshold(32 * 1024) { }
+
+	unsigned thread_count; // 0 = one per hardware thread
+
+	// Format 1 files of at least this many bytes get one task per track instead of one for the whole file.
+	// Files below it are read into the worker's arena (see process_files).
+	size_t split_threshold;
+};
+
+struct BATCH_STATISTICS
+{
+	size_t files;
+	size_t failed;
+	uint64_t bytes;
+	uint64_t notes;
+	double seconds;
+
+	double files_per_second() const { return seconds > 0 ? files / seconds : 0; }
+	double megabytes_per_second() const { return seconds > 0 ? bytes / (1024.0 * 1024.0) / seconds : 0; }
+};
+
+/*
+	Called once per file that was read successfully, with its notes in the same
+	order as read_notes would give them. The notes are only valid during the call
+	(they usually live in the worker's ParseContext). Calls for different files
+	can happen at the same time on different threads.
+*/
+typedef std::function<void(const std::string& path, const NOTE* notes, size_t count)> NoteConsumer;
+
+/*
+	Reads all given files on a WorkStealingPool and passes their notes to consumer
+	(which may be empty). Files that cannot be read are counted in failed.
+	Each worker parses into its own ParseContext, which is reset between files.
+
+	Whether a file is split is decided from its size before it is read. Files below
+	split_threshold are read into the worker's arena. Larger ones are opened with
+	MidiBuffer::open (mapped if large enough) and are never copied: format 1 files
+	move into per-track tasks, which decode into vectors of their own on the heap,
+	and the rest are handed to the ParseContext, whose arena then only holds the notes.
+*/
+BATCH_STATISTICS process_files(const std::vector<std::string>& paths, const BATCH_OPTIONS& options, const NoteConsumer& consumer);
+
+/*
+	If path is a directory, appends the paths of the .mid and .midi files in it
+	(not in subdirectories) in alphabetical order; otherwise appends path itself.
+	Returns false if path is a directory that cannot be read.
+*/
+bool list_midi_files(const std::string& path, std::vector<std::string>* paths);
+
+#endif
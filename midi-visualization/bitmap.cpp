@@ -1,5 +1,6 @@
 #include "bitmap.h"
 #include "array.h"
+#include "file-loader.h"
 #include <algorithm>
 #include <assert.h>
 #include <stdint.h>
@@ -181,31 +182,21 @@ namespace
         return Color{ r, g, b };
     }
 
-    unsigned file_size(std::ifstream& in)
-    {
-        auto position = in.tellg();
-        in.seekg(0, std::ios::end);
-        auto length = in.tellg();
-        in.seekg(position, std::ios::beg);
-
-        return unsigned(length);
-    }
-
     array<uint8_t> read_data(const std::string& path)
     {
-        std::ifstream in(path, std::ios::binary);
+        array<uint8_t> buffer(0);
+        auto allocate = [&buffer](size_t size) {
+            buffer = array<uint8_t>(size);
+            return buffer.ptr();
+        };
 
-        if (!in)
+        if (!read_file(path, allocate))
         {
             std::cerr << "Could not open file " << path << std::endl;
             abort();
         }
         else
         {
-            unsigned size = file_size(in);
-            array<uint8_t> buffer(size);
-            in.read(reinterpret_cast<char*>(buffer.ptr()), buffer.size());
-
             return buffer;
         }
     }
@@ -288,6 +279,29 @@ namespace
         }
     }
 
+    Bitmap load_bitmap(const std::string& path)
+    {
+        array<uint8_t> data = read_data(path);
+        const BITMAP_FILE_V5* header = reinterpret<BITMAP_FILE_V5>(data);
+
+        verify_file_header(&header->file_header);
+        verify_bitmap_header(&header->bitmap_header);
+
+        Bitmap bitmap(unsigned(header->bitmap_header.Width), unsigned(header->bitmap_header.Height));
+        array<uint8_t> pixels = data.slice(header->file_header.BitmapOffset);
+
+        if (header->bitmap_header.BitsPerPixel == 24)
+        {
+            read_24bit_pixels(bitmap, pixels);
+        }
+        else
+        {
+            read_32bit_pixels(bitmap, pixels);
+        }
+
+        return bitmap;
+    }
+
     void save_bitmap(const std::string& path, const Bitmap& bitmap)
     {
         BITMAP_FILE_V5 header;
@@ -440,6 +454,11 @@ void Bitmap::save(const std::string& path) const
     save_bitmap(path, *this);
 }
 
+Bitmap Bitmap::load(const std::string& path)
+{
+    return load_bitmap(path);
+}
+
 Bitmap Bitmap::slice(int x, int y, int width, int height) const
 {
     Bitmap result(width, height, [x, y, this](const Position2D& p) {
@@ -105,6 +105,11 @@ public:
     /// </summary>
     void save(const std::string&) const;
 
+    /// <summary>
+    /// Reads a bitmap written by <see cref="save" /> (or any uncompressed 24 or 32 bit V5 bitmap).
+    /// </summary>
+    static Bitmap load(const std::string&);
+
 private:
     data::Grid<Color> m_pixels;
 };
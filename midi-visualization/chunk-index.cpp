@@ -0,0 +1,92 @@
+#include "chunk-index.h"
+#include <cstring>
+
+
+namespace
+{
+	ChunkKind kind_of(const CHUNK_HEADER& header)
+	{
+		if (std::memcmp(header.id, "MTrk", 4) == 0)
+		{
+			return ChunkKind::MTrk;
+		}
+		else if (std::memcmp(header.id, "MThd", 4) == 0)
+		{
+			return ChunkKind::MThd;
+		}
+		else
+		{
+			return ChunkKind::Unknown;
+		}
+	}
+}
+
+
+ChunkIndex::ChunkIndex()
+	: m_data(nullptr)
+	, m_size(0)
+	, m_truncated(false)
+{
+	// NOP
+}
+
+bool ChunkIndex::build(const uint8_t* data, size_t size)
+{
+	m_data = data;
+	m_size = size;
+	m_truncated = false;
+	m_chunks.clear();
+	m_tracks.clear();
+
+	ByteCursor cursor(data, size);
+
+	while (!cursor.at_end())
+	{
+		CHUNK_ENTRY entry;
+		entry.offset = size_t(cursor.position() - data);
+
+		if (!read_header(cursor, &entry.header) || !cursor.skip(entry.header.size))
+		{
+			m_truncated = true;
+			return false;
+		}
+
+		entry.kind = kind_of(entry.header);
+
+		if (entry.kind == ChunkKind::MTrk)
+		{
+			m_tracks.push_back(m_chunks.size());
+		}
+
+		m_chunks.push_back(entry);
+	}
+
+	return true;
+}
+
+bool ChunkIndex::build(const MidiBuffer& buffer)
+{
+	return build(buffer.data(), buffer.size());
+}
+
+const CHUNK_ENTRY* ChunkIndex::header_chunk() const
+{
+	if (m_chunks.empty() || m_chunks.front().kind != ChunkKind::MThd)
+	{
+		return nullptr;
+	}
+
+	return &m_chunks.front();
+}
+
+ByteCursor ChunkIndex::track(size_t index) const
+{
+	const CHUNK_ENTRY& entry = track_entry(index);
+
+	return ByteCursor(m_data + entry.offset, sizeof(CHUNK_HEADER) + entry.header.size);
+}
+
+ByteCursor ChunkIndex::chunk_data(const CHUNK_ENTRY& entry) const
+{
+	return ByteCursor(m_data + entry.offset + sizeof(CHUNK_HEADER), entry.header.size);
+}
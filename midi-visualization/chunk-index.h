@@ -0,0 +1,64 @@
+#ifndef CHUNK_INDEX_H
+#define CHUNK_INDEX_H
+#include "midi.h"
+#include "midi-buffer.h"
+#include <vector>
+
+
+enum class ChunkKind
+{
+	MThd,
+	MTrk,
+	Unknown
+};
+
+struct CHUNK_ENTRY
+{
+	ChunkKind kind;
+	size_t offset; // position of the chunk header, counted from the start of the file
+	CHUNK_HEADER header;
+};
+
+
+/*
+	Directory of all chunks in a MIDI file, built by hopping from chunk header
+	to chunk header without looking at the data in between.
+
+	Once built, tracks can be opened in any order with track(i) and
+	unknown chunks cost nothing. build() returns false if the last chunk
+	is cut off; the chunks before it are still listed.
+*/
+class ChunkIndex
+{
+public:
+	ChunkIndex();
+
+	bool build(const uint8_t* data, size_t size);
+	bool build(const MidiBuffer& buffer);
+
+	const std::vector<CHUNK_ENTRY>& chunks() const { return m_chunks; }
+
+	bool is_truncated() const { return m_truncated; }
+
+	// Returns the MThd chunk, or nullptr if the file does not start with one.
+	const CHUNK_ENTRY* header_chunk() const;
+
+	size_t track_count() const { return m_tracks.size(); }
+
+	const CHUNK_ENTRY& track_entry(size_t index) const { return m_chunks[m_tracks[index]]; }
+
+	// Cursor positioned at the chunk header of the index-th MTrk.
+	ByteCursor track(size_t index) const;
+
+	// Cursor over the data of the given chunk, i.e. without its header.
+	ByteCursor chunk_data(const CHUNK_ENTRY& entry) const;
+
+private:
+	const uint8_t* m_data;
+	size_t m_size;
+	bool m_truncated;
+	std::vector<CHUNK_ENTRY> m_chunks;
+	std::vector<size_t> m_tracks;
+};
+
+#endif
@@ -1,19 +1,67 @@
 #include "endianness.h"
+#include "simd.h"
 
 
-void switch_endianness(uint16_t* x)
+void swap_endianness(uint16_t* values, size_t count)
 {
+	size_t i = 0;
 
-	*x = (*x >> 8) |
-		((*x << 8) & 0x00FF0000) |
-		((*x >> 8) & 0x0000FF00) |
-		(*x << 8);
+#ifdef MIDI_USE_AVX2
+	const __m256i shuffle16 = _mm256_setr_epi8(
+		1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+		1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+
+	for (; i + 16 <= count; i += 16)
+	{
+		__m256i* p = reinterpret_cast<__m256i*>(values + i);
+		_mm256_storeu_si256(p, _mm256_shuffle_epi8(_mm256_loadu_si256(p), shuffle16));
+	}
+#endif
+
+#ifdef MIDI_USE_SSE2
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i* p = reinterpret_cast<__m128i*>(values + i);
+		__m128i v = _mm_loadu_si128(p);
+		_mm_storeu_si128(p, _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8)));
+	}
+#endif
+
+	for (; i != count; ++i)
+	{
+		switch_endianness(&values[i]);
+	}
 }
 
-void switch_endianness(uint32_t* x)
+void swap_endianness(uint32_t* values, size_t count)
 {
-	*x = (*x >> 24) |
-		((*x << 8) & 0x00FF0000) |
-		((*x >> 8) & 0x0000FF00) |
-		(*x << 24);
+	size_t i = 0;
+
+#ifdef MIDI_USE_AVX2
+	const __m256i shuffle32 = _mm256_setr_epi8(
+		3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+		3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256i* p = reinterpret_cast<__m256i*>(values + i);
+		_mm256_storeu_si256(p, _mm256_shuffle_epi8(_mm256_loadu_si256(p), shuffle32));
+	}
+#endif
+
+#ifdef MIDI_USE_SSE2
+	for (; i + 4 <= count; i += 4)
+	{
+		// Swap the bytes within each 16-bit half, then swap the halves
+		__m128i* p = reinterpret_cast<__m128i*>(values + i);
+		__m128i v = _mm_loadu_si128(p);
+		v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+		_mm_storeu_si128(p, _mm_or_si128(_mm_slli_epi32(v, 16), _mm_srli_epi32(v, 16)));
+	}
+#endif
+
+	for (; i != count; ++i)
+	{
+		switch_endianness(&values[i]);
+	}
 }
@@ -1,10 +1,54 @@
 #ifndef ENDIANNESS_H
 #define ENDIANNESS_H
 #include "stdint.h"
+#include <stddef.h>
 
-void switch_endianness(uint16_t* x);
-void switch_endianness(uint32_t* x);
 
+constexpr uint16_t byte_swap16(uint16_t x)
+{
+	return uint16_t((x >> 8) | (x << 8));
+}
 
-#endif // !ENDIANNESS_H
+constexpr uint32_t byte_swap32(uint32_t x)
+{
+	return (x >> 24) |
+		((x << 8) & 0x00FF0000) |
+		((x >> 8) & 0x0000FF00) |
+		(x << 24);
+}
+
+/*
+	Read a big-endian integer from (possibly unaligned) memory.
+	They are written in terms of bytes and shifts, which compilers turn into a single
+	load followed by bswap (or a movbe) on little-endian hosts and a plain load on
+	big-endian hosts, so there is no separate "read, then swap in place" step.
+*/
+constexpr uint16_t load_be16(const uint8_t* p)
+{
+	return uint16_t((uint16_t(p[0]) << 8) | uint16_t(p[1]));
+}
+
+constexpr uint32_t load_be32(const uint8_t* p)
+{
+	return (uint32_t(p[0]) << 24) |
+		(uint32_t(p[1]) << 16) |
+		(uint32_t(p[2]) << 8) |
+		uint32_t(p[3]);
+}
+
+inline void switch_endianness(uint16_t* x)
+{
+	*x = byte_swap16(*x);
+}
 
+inline void switch_endianness(uint32_t* x)
+{
+	*x = byte_swap32(*x);
+}
+
+// Swaps the byte order of count values in place.
+void swap_endianness(uint16_t* values, size_t count);
+void swap_endianness(uint32_t* values, size_t count);
+
+
+#endif // !ENDIANNESS_H
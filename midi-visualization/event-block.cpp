@@ -0,0 +1,207 @@
+#include "event-block.h"
+#include "static-receivers.h"
+#include <cstring>
+
+
+const size_t EVENT_BLOCK::capacity;
+
+
+namespace
+{
+	/*
+		Static receiver (see static-receivers.h) that fills an EVENT_BLOCK and
+		hands it over whenever it is full.
+	*/
+	class BlockBuilder
+	{
+	public:
+		explicit BlockBuilder(EventBlockReceiver& receiver)
+			: m_receiver(receiver)
+			, m_time(0)
+		{
+			m_block.size = 0;
+		}
+
+		bool wants_meta() const { return m_receiver.wants_meta(); }
+		bool wants_sysex() const { return m_receiver.wants_sysex(); }
+
+		void note_on(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) { add(dt, 0x90 | channel, note, velocity); }
+		void note_off(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) { add(dt, 0x80 | channel, note, velocity); }
+		void polyphonic_key_pressure(uint32_t dt, uint8_t channel, uint8_t note, uint8_t pressure) { add(dt, 0xA0 | channel, note, pressure); }
+		void control_change(uint32_t dt, uint8_t channel, uint8_t controller, uint8_t value) { add(dt, 0xB0 | channel, controller, value); }
+		void program_change(uint32_t dt, uint8_t channel, uint8_t program) { add(dt, 0xC0 | channel, program, 0); }
+		void channel_pressure(uint32_t dt, uint8_t channel, uint8_t pressure) { add(dt, 0xD0 | channel, pressure, 0); }
+		void pitch_wheel_change(uint32_t dt, uint8_t channel, uint16_t value) { add(dt, 0xE0 | channel, uint8_t(value & 0xFF), uint8_t(value >> 8)); }
+
+		void meta(uint32_t dt, uint8_t type, const char* data, int data_size)
+		{
+			add(dt, 0xFF, type, 0, reinterpret_cast<const uint8_t*>(data), uint32_t(data_size));
+		}
+
+		void sysex(uint32_t dt, const char* data, int data_size)
+		{
+			// The decoder does not tell 0xF0 from 0xF7; both are passed on as 0xF0
+			add(dt, 0xF0, 0, 0, reinterpret_cast<const uint8_t*>(data), uint32_t(data_size));
+		}
+
+		void flush()
+		{
+			if (m_block.size != 0)
+			{
+				m_receiver.events(m_block);
+				m_block.size = 0;
+			}
+		}
+
+	private:
+		void add(uint32_t dt, unsigned status, uint8_t d1, uint8_t d2, const uint8_t* payload = nullptr, uint32_t payload_size = 0)
+		{
+			size_t i = m_block.size++;
+			m_time += dt;
+
+			m_block.time[i] = m_time;
+			m_block.status[i] = uint8_t(status);
+			m_block.d1[i] = d1;
+			m_block.d2[i] = d2;
+			m_block.payload[i] = payload;
+			m_block.payload_size[i] = payload_size;
+
+			if (m_block.size == EVENT_BLOCK::capacity)
+			{
+				flush();
+			}
+		}
+
+		EventBlockReceiver& m_receiver;
+		uint32_t m_time;
+		EVENT_BLOCK m_block;
+	};
+}
+
+
+bool read_mtrk_blocks(ByteCursor& in, EventBlockReceiver& receiver)
+{
+	BlockBuilder builder(receiver);
+
+	if (!read_mtrk(in, builder))
+	{
+		receiver.abort_track();
+		return false;
+	}
+
+	builder.flush();
+	receiver.end_track();
+	return true;
+}
+
+
+EventBlockAdapter::EventBlockAdapter(EventReceiver& receiver)
+	: m_receiver(receiver)
+	, m_time(0)
+{
+	// NOP
+}
+
+void EventBlockAdapter::events(const EVENT_BLOCK& block)
+{
+	for (size_t i = 0; i != block.size; ++i)
+	{
+		uint32_t dt = block.time[i] - m_time;
+		uint8_t status = block.status[i];
+		uint8_t channel = status & 0x0F;
+		m_time = block.time[i];
+
+		switch (status >> 4)
+		{
+		case 0x8: m_receiver.note_off(dt, channel, block.d1[i], block.d2[i]); break;
+		case 0x9: m_receiver.note_on(dt, channel, block.d1[i], block.d2[i]); break;
+		case 0xA: m_receiver.polyphonic_key_pressure(dt, channel, block.d1[i], block.d2[i]); break;
+		case 0xB: m_receiver.control_change(dt, channel, block.d1[i], block.d2[i]); break;
+		case 0xC: m_receiver.program_change(dt, channel, block.d1[i]); break;
+		case 0xD: m_receiver.channel_pressure(dt, channel, block.d1[i]); break;
+		case 0xE: m_receiver.pitch_wheel_change(dt, channel, uint16_t(block.d1[i] | (block.d2[i] << 8))); break;
+		default:
+			if (status == 0xFF)
+			{
+				m_receiver.meta(dt, block.d1[i], reinterpret_cast<const char*>(block.payload[i]), int(block.payload_size[i]));
+			}
+			else
+			{
+				m_receiver.sysex(dt, reinterpret_cast<const char*>(block.payload[i]), int(block.payload_size[i]));
+			}
+			break;
+		}
+	}
+}
+
+
+BlockNoteCollector::BlockNoteCollector(std::vector<NOTE>* notes)
+	: m_notes(notes)
+{
+	end_track();
+}
+
+void BlockNoteCollector::end_track()
+{
+	// Notes still playing at the end of a track are dropped, as by NoteFilter
+	std::memset(m_start, 0, sizeof(m_start));
+	std::memset(m_playing, 0, sizeof(m_playing));
+}
+
+void BlockNoteCollector::events(const EVENT_BLOCK& block)
+{
+	for (size_t i = 0; i != block.size; ++i)
+	{
+		uint8_t status = block.status[i];
+		unsigned kind = status >> 4;
+
+		if (kind != 0x8 && kind != 0x9)
+		{
+			continue;
+		}
+
+		uint8_t channel = status & 0x0F;
+		uint8_t note = block.d1[i] & 0x7F;
+		uint32_t time = block.time[i];
+
+		if (m_playing[channel][note])
+		{
+			m_notes->push_back(NOTE{ channel, note, m_start[channel][note], time - m_start[channel][note] });
+			m_playing[channel][note] = false;
+		}
+
+		if (kind == 0x9 && block.d2[i] != 0)
+		{
+			m_start[channel][note] = time;
+			m_playing[channel][note] = true;
+		}
+	}
+}
+
+
+ControllerStatistics::ControllerStatistics()
+{
+	std::memset(m_counts, 0, sizeof(m_counts));
+	std::memset(m_last_value, 0, sizeof(m_last_value));
+	std::memset(m_changes, 0, sizeof(m_changes));
+}
+
+void ControllerStatistics::events(const EVENT_BLOCK& block)
+{
+	for (size_t i = 0; i != block.size; ++i)
+	{
+		++m_counts[block.status[i] >> 4];
+	}
+
+	for (size_t i = 0; i != block.size; ++i)
+	{
+		if ((block.status[i] & 0xF0) == 0xB0)
+		{
+			uint8_t channel = block.status[i] & 0x0F;
+			uint8_t controller = block.d1[i] & 0x7F;
+
+			m_last_value[channel][controller] = block.d2[i];
+			++m_changes[channel][controller];
+		}
+	}
+}
@@ -0,0 +1,121 @@
+#ifndef EVENT_BLOCK_H
+#define EVENT_BLOCK_H
+#include "midi.h"
+#include <cstdint>
+#include <vector>
+
+
+/*
+	Up to 256 decoded events of one track, one array per field (structure of arrays),
+	so that a consumer can run a tight loop over just the columns it needs.
+
+	time is the absolute time of the event in ticks since the start of the track.
+	status is the status byte after running status has been resolved; d1 and d2 are
+	the data bytes (0 if the event has fewer). For meta events status is 0xFF, d1 is the
+	meta type and payload/payload_size describe the data; the same goes for sysex
+	(0xF0 or 0xF7) without the type. payload points into the track data and is only
+	valid while the block is being handled. For channel events it is nullptr.
+*/
+struct EVENT_BLOCK
+{
+	static const size_t capacity = 256;
+
+	size_t size;
+	uint32_t time[capacity];
+	uint8_t status[capacity];
+	uint8_t d1[capacity];
+	uint8_t d2[capacity];
+	const uint8_t* payload[capacity];
+	uint32_t payload_size[capacity];
+};
+
+/*
+	Block-at-a-time counterpart of EventReceiver. read_mtrk_blocks hands over full
+	blocks as the track is decoded, then the last partial block, then calls end_track.
+	If the track turns out to be broken, the partial block is dropped and abort_track
+	is called instead, so that nothing of the broken track carries over into the next.
+	As with EventReceiver, meta and sysex events are left out unless wanted.
+*/
+class EventBlockReceiver
+{
+public:
+	virtual ~EventBlockReceiver() { }
+
+	virtual bool wants_meta() const { return true; }
+	virtual bool wants_sysex() const { return true; }
+
+	virtual void events(const EVENT_BLOCK& block) = 0;
+	virtual void end_track() { }
+	virtual void abort_track() { end_track(); }
+};
+
+bool read_mtrk_blocks(ByteCursor& in, EventBlockReceiver& receiver);
+
+/*
+	Turns blocks back into one EventReceiver call per event, so existing receivers
+	can be fed from a block stream. dt is recomputed from the absolute times and
+	restarts at the beginning of every track.
+*/
+class EventBlockAdapter : public EventBlockReceiver
+{
+public:
+	explicit EventBlockAdapter(EventReceiver& receiver);
+
+	bool wants_meta() const override { return m_receiver.wants_meta(); }
+	bool wants_sysex() const override { return m_receiver.wants_sysex(); }
+
+	void events(const EVENT_BLOCK& block) override;
+	void end_track() override { m_time = 0; }
+
+private:
+	EventReceiver& m_receiver;
+	uint32_t m_time;
+};
+
+/*
+	Pairs note on and note off events like ChannelNoteCollector and produces the same
+	NOTEs in the same order, one block at a time.
+*/
+class BlockNoteCollector : public EventBlockReceiver
+{
+public:
+	explicit BlockNoteCollector(std::vector<NOTE>* notes);
+
+	bool wants_meta() const override { return false; }
+	bool wants_sysex() const override { return false; }
+
+	void events(const EVENT_BLOCK& block) override;
+	void end_track() override;
+
+private:
+	std::vector<NOTE>* m_notes;
+	uint32_t m_start[16][128];
+	bool m_playing[16][128];
+};
+
+/*
+	Counts the events of every kind and the value of the last
+	control change per channel and controller.
+*/
+class ControllerStatistics : public EventBlockReceiver
+{
+public:
+	ControllerStatistics();
+
+	bool wants_meta() const override { return false; }
+	bool wants_sysex() const override { return false; }
+
+	void events(const EVENT_BLOCK& block) override;
+
+	// Indexed by the upper 4 bits of the status byte (0x8 = note off ... 0xE = pitch wheel)
+	const uint32_t* counts_by_kind() const { return m_counts; }
+	uint8_t last_value(uint8_t channel, uint8_t controller) const { return m_last_value[channel][controller]; }
+	uint32_t control_changes(uint8_t channel, uint8_t controller) const { return m_changes[channel][controller]; }
+
+private:
+	uint32_t m_counts[16];
+	uint8_t m_last_value[16][128];
+	uint32_t m_changes[16][128];
+};
+
+#endif
@@ -0,0 +1,177 @@
+#include "event-queue.h"
+
+
+QueueingReceiver::QueueingReceiver(EventQueue& queue, const EventReceiver& consumer)
+	: QueueingReceiver(queue, consumer.wants_meta(), consumer.wants_sysex())
+{
+	// NOP
+}
+
+QueueingReceiver::QueueingReceiver(EventQueue& queue, bool wants_meta, bool wants_sysex)
+	: m_queue(queue)
+	, m_wants_meta(wants_meta)
+	, m_wants_sysex(wants_sysex)
+{
+	// NOP
+}
+
+void QueueingReceiver::push(uint32_t dt, unsigned status, uint8_t d1, uint8_t d2, uint32_t payload_size)
+{
+	m_queue.events.push(QUEUED_EVENT{ dt, payload_size, uint8_t(status), d1, d2 });
+}
+
+void QueueingReceiver::meta(uint32_t dt, uint8_t type, const char* data, int data_size)
+{
+	// The event goes first, so the consumer knows how many payload bytes to wait for
+	push(dt, 0xFF, type, 0, uint32_t(data_size));
+	m_queue.payload.push(reinterpret_cast<const uint8_t*>(data), size_t(data_size));
+}
+
+void QueueingReceiver::sysex(uint32_t dt, const char* data, int data_size)
+{
+	push(dt, 0xF0, 0, 0, uint32_t(data_size));
+	m_queue.payload.push(reinterpret_cast<const uint8_t*>(data), size_t(data_size));
+}
+
+void QueueingReceiver::finish()
+{
+	push(0, 0, 0, 0);
+}
+
+
+void deliver_queued_event(const QUEUED_EVENT& event, const uint8_t* payload, EventReceiver& receiver)
+{
+	uint8_t channel = event.status & 0x0F;
+	const char* data = reinterpret_cast<const char*>(payload);
+
+	switch (event.status >> 4)
+	{
+	case 0x8: receiver.note_off(event.dt, channel, event.d1, event.d2); break;
+	case 0x9: receiver.note_on(event.dt, channel, event.d1, event.d2); break;
+	case 0xA: receiver.polyphonic_key_pressure(event.dt, channel, event.d1, event.d2); break;
+	case 0xB: receiver.control_change(event.dt, channel, event.d1, event.d2); break;
+	case 0xC: receiver.program_change(event.dt, channel, event.d1); break;
+	case 0xD: receiver.channel_pressure(event.dt, channel, event.d1); break;
+	case 0xE: receiver.pitch_wheel_change(event.dt, channel, uint16_t(event.d1 | (event.d2 << 8))); break;
+	default:
+		if (event.status == 0xFF)
+		{
+			receiver.meta(event.dt, event.d1, data, int(event.payload_size));
+		}
+		else
+		{
+			receiver.sysex(event.dt, data, int(event.payload_size));
+		}
+		break;
+	}
+}
+
+
+DrainingSource::DrainingSource(EventQueue& queue)
+	: m_queue(queue)
+	, m_has_pending(false)
+	, m_received(0)
+	, m_finished(false)
+{
+	// NOP
+}
+
+void DrainingSource::begin(const QUEUED_EVENT& event)
+{
+	m_pending = event;
+	m_has_pending = true;
+	m_received = 0;
+
+	// m_payload only grows, so after the largest payload there are no more allocations
+	if (m_payload.size() < event.payload_size)
+	{
+		m_payload.resize(event.payload_size);
+	}
+}
+
+// Delivers the pending event once all of its payload is there; returns false if some is still missing
+bool DrainingSource::complete(EventReceiver& receiver, bool wait)
+{
+	size_t missing = m_pending.payload_size - m_received;
+
+	if (missing != 0)
+	{
+		uint8_t* destination = m_payload.data() + m_received;
+
+		if (wait)
+		{
+			m_queue.payload.pop(destination, missing);
+			m_received += uint32_t(missing);
+		}
+		else
+		{
+			m_received += uint32_t(m_queue.payload.try_pop(destination, missing));
+		}
+
+		if (m_received != m_pending.payload_size)
+		{
+			return false;
+		}
+	}
+
+	m_has_pending = false;
+
+	if (m_pending.status == 0)
+	{
+		m_finished = true;
+	}
+	else
+	{
+		deliver_queued_event(m_pending, m_payload.data(), receiver);
+	}
+
+	return true;
+}
+
+void DrainingSource::drain(EventReceiver& receiver)
+{
+	QUEUED_EVENT event;
+
+	while (!m_finished)
+	{
+		// drain_available may have left an event waiting for its payload
+		if (!m_has_pending)
+		{
+			m_queue.events.pop(&event);
+			begin(event);
+		}
+
+		complete(receiver, true);
+	}
+}
+
+size_t DrainingSource::drain_available(EventReceiver& receiver, size_t max)
+{
+	QUEUED_EVENT event;
+	size_t delivered = 0;
+
+	while (!m_finished && delivered != max)
+	{
+		if (!m_has_pending)
+		{
+			if (!m_queue.events.try_pop(&event))
+			{
+				break;
+			}
+
+			begin(event);
+		}
+
+		if (!complete(receiver, false))
+		{
+			break;
+		}
+
+		if (!m_finished)
+		{
+			++delivered;
+		}
+	}
+
+	return delivered;
+}
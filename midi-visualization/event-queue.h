@@ -0,0 +1,122 @@
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+#include "midi.h"
+#include "spsc-queue.h"
+#include <cstdint>
+#include <vector>
+
+
+/*
+	Lets a receiver run on a different thread than the MTrk decoder.
+
+		EventQueue queue;
+		QueueingReceiver producer(queue, collector);   // decoder thread
+		DrainingSource consumer(queue);                 // receiver thread
+
+		decoder thread:  read_mtrk(track, producer); producer.finish();
+		receiver thread: consumer.drain(collector);
+
+	Events travel through an SpscQueue of fixed size records; meta and sysex payloads
+	follow through a second SpscQueue of bytes, in pieces if they are larger than it.
+	Neither side takes a lock or allocates per event. When the consumer falls behind
+	and a queue fills up, the decoder waits (backpressure).
+*/
+
+
+// One event in the queue. Pitch wheel values are split over d1 (low byte) and d2 (high byte).
+struct QUEUED_EVENT
+{
+	uint32_t dt;
+	uint32_t payload_size; // Meta and sysex only; that many bytes follow in the payload queue
+	uint8_t status;        // 0 marks the end of the stream, 0xFF a meta event, 0xF0 a sysex event
+	uint8_t d1;            // Meta type for meta events
+	uint8_t d2;
+};
+
+struct EventQueue
+{
+	explicit EventQueue(size_t event_capacity = 4096, size_t payload_capacity = 64 * 1024)
+		: events(event_capacity)
+		, payload(payload_capacity)
+	{
+	}
+
+	SpscQueue<QUEUED_EVENT> events;
+	SpscQueue<uint8_t> payload;
+};
+
+// Calls the receiver method for one event; payload holds its payload_size bytes.
+void deliver_queued_event(const QUEUED_EVENT& event, const uint8_t* payload, EventReceiver& receiver);
+
+/*
+	The producer side: an EventReceiver that puts every event in the queue.
+	The consumer's wants_meta()/wants_sysex() are asked once, on construction,
+	so unwanted payloads never cross over.
+*/
+class QueueingReceiver final : public EventReceiver
+{
+public:
+	QueueingReceiver(EventQueue& queue, const EventReceiver& consumer);
+	QueueingReceiver(EventQueue& queue, bool wants_meta = true, bool wants_sysex = true);
+
+	bool wants_meta() const override { return m_wants_meta; }
+	bool wants_sysex() const override { return m_wants_sysex; }
+
+	void note_on(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) override { push(dt, 0x90 | channel, note, velocity); }
+	void note_off(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) override { push(dt, 0x80 | channel, note, velocity); }
+	void polyphonic_key_pressure(uint32_t dt, uint8_t channel, uint8_t note, uint8_t pressure) override { push(dt, 0xA0 | channel, note, pressure); }
+	void control_change(uint32_t dt, uint8_t channel, uint8_t controller, uint8_t value) override { push(dt, 0xB0 | channel, controller, value); }
+	void program_change(uint32_t dt, uint8_t channel, uint8_t program) override { push(dt, 0xC0 | channel, program, 0); }
+	void channel_pressure(uint32_t dt, uint8_t channel, uint8_t pressure) override { push(dt, 0xD0 | channel, pressure, 0); }
+	void pitch_wheel_change(uint32_t dt, uint8_t channel, uint16_t value) override { push(dt, 0xE0 | channel, uint8_t(value & 0xFF), uint8_t(value >> 8)); }
+	void meta(uint32_t dt, uint8_t type, const char* data, int data_size) override;
+	void sysex(uint32_t dt, const char* data, int data_size) override;
+
+	// Tells the consumer no more events will follow.
+	void finish();
+
+private:
+	void push(uint32_t dt, unsigned status, uint8_t d1, uint8_t d2, uint32_t payload_size = 0);
+
+	EventQueue& m_queue;
+	bool m_wants_meta;
+	bool m_wants_sysex;
+};
+
+/*
+	The consumer side: takes events out of the queue and passes them on to a receiver.
+
+	A DrainingSource reads one stream, up to the producer's finish(). To read the
+	next stream the producer sends through the same queue, call reset() first.
+*/
+class DrainingSource
+{
+public:
+	explicit DrainingSource(EventQueue& queue);
+
+	// Delivers events until the producer calls finish(), waiting for them as needed.
+	void drain(EventReceiver& receiver);
+
+	// Delivers at most max events that are already in the queue, without waiting, and returns how many.
+	// For a render loop that polls; finished() tells when the end of the stream was reached.
+	// A meta or sysex event whose payload has not fully arrived yet is held back until a later call.
+	size_t drain_available(EventReceiver& receiver, size_t max);
+
+	bool finished() const { return m_finished; }
+
+	// Gets ready for the next stream; only call once finished() is true.
+	void reset() { m_finished = false; }
+
+private:
+	void begin(const QUEUED_EVENT& event);
+	bool complete(EventReceiver& receiver, bool wait);
+
+	EventQueue& m_queue;
+	std::vector<uint8_t> m_payload;
+	QUEUED_EVENT m_pending;  // Taken out of the event queue, but not delivered yet
+	bool m_has_pending;
+	uint32_t m_received;     // Payload bytes of m_pending received so far
+	bool m_finished;
+};
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef EVENT_TABLE_H
+#define EVENT_TABLE_H
+#include "midi.h"
+#include <cstdint>
+
+
+enum class EventClass : uint8_t
+{
+	Data, // Not a status byte: the event reuses the running status
+	NoteOff,
+	NoteOn,
+	PolyphonicKeyPressure,
+	ControlChange,
+	ProgramChange,
+	ChannelPressure,
+	PitchWheelChange,
+	Sysex,
+	Meta,
+	Invalid // System common/real-time messages, which cannot appear in a MIDI file
+};
+
+struct EVENT_INFO
+{
+	EventClass event_class;
+	uint8_t data_length; // Number of data bytes after the status byte, 0 for variable length events
+	bool running_status; // Whether the status byte becomes the running status
+};
+
+struct EVENT_TABLE
+{
+	EVENT_INFO entries[256];
+
+	constexpr const EVENT_INFO& operator [](uint8_t status) const
+	{
+		return entries[status];
+	}
+};
+
+constexpr EVENT_TABLE make_event_table()
+{
+	EVENT_TABLE table{};
+
+	for (unsigned status = 0; status != 256; ++status)
+	{
+		EVENT_INFO& info = table.entries[status];
+		info.running_status = status >= 0x80 && status < 0xF0;
+
+		switch (status >> 4)
+		{
+		case 0x8: info.event_class = EventClass::NoteOff; info.data_length = 2; break;
+		case 0x9: info.event_class = EventClass::NoteOn; info.data_length = 2; break;
+		case 0xA: info.event_class = EventClass::PolyphonicKeyPressure; info.data_length = 2; break;
+		case 0xB: info.event_class = EventClass::ControlChange; info.data_length = 2; break;
+		case 0xC: info.event_class = EventClass::ProgramChange; info.data_length = 1; break;
+		case 0xD: info.event_class = EventClass::ChannelPressure; info.data_length = 1; break;
+		case 0xE: info.event_class = EventClass::PitchWheelChange; info.data_length = 2; break;
+		case 0xF:
+			info.data_length = 0;
+			info.event_class = status == 0xFF ? EventClass::Meta
+				: status == 0xF0 || status == 0xF7 ? EventClass::Sysex
+				: EventClass::Invalid;
+			break;
+		default: info.event_class = EventClass::Data; info.data_length = 0; break;
+		}
+	}
+
+	return table;
+}
+
+/*
+	Maps every possible status byte to its event class, its number of data bytes
+	and whether it sets the running status, so decoders classify an event with
+	a single lookup.
+*/
+constexpr EVENT_TABLE event_table = make_event_table();
+
+/*
+	Passes a complete channel event (note on/off, controller, ...) on to the receiver.
+	Receiver is an EventReceiver or any type with the same event methods (see static-receivers.h).
+*/
+template<typename Receiver>
+inline void dispatch_channel_event(Receiver& receiver, EventClass event_class, uint32_t dt, uint8_t status, uint8_t first, uint8_t second)
+{
+	uint8_t channel = status & 0x0F;
+
+	switch (event_class)
+	{
+	case EventClass::NoteOff:
+		receiver.note_off(dt, channel, first, second);
+		break;
+	case EventClass::NoteOn:
+		receiver.note_on(dt, channel, first, second);
+		break;
+	case EventClass::PolyphonicKeyPressure:
+		receiver.polyphonic_key_pressure(dt, channel, first, second);
+		break;
+	case EventClass::ControlChange:
+		receiver.control_change(dt, channel, first, second);
+		break;
+	case EventClass::ProgramChange:
+		receiver.program_change(dt, channel, first);
+		break;
+	case EventClass::ChannelPressure:
+		receiver.channel_pressure(dt, channel, first);
+		break;
+	case EventClass::PitchWheelChange:
+		receiver.pitch_wheel_change(dt, channel, uint16_t(first | (second << 8)));
+		break;
+	default:
+		break;
+	}
+}
+
+#endif
@@ -0,0 +1,259 @@
+#include "file-loader.h"
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace
+{
+#ifdef _WIN32
+	typedef HANDLE FileHandle;
+#else
+	typedef int FileHandle;
+#endif
+
+	// Opens the file and asks for its size; that is all the metadata a load needs.
+	bool open_file(const std::string& path, bool sequential, FileHandle* handle, size_t* size)
+	{
+#ifdef _WIN32
+		DWORD flags = sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL;
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER file_size;
+
+		if (!GetFileSizeEx(file, &file_size))
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		*handle = file;
+		*size = size_t(file_size.QuadPart);
+		return true;
+#else
+		int fd = ::open(path.c_str(), O_RDONLY);
+
+		if (fd < 0)
+		{
+			return false;
+		}
+
+		struct stat info;
+
+		if (fstat(fd, &info) != 0)
+		{
+			::close(fd);
+			return false;
+		}
+
+#ifdef POSIX_FADV_SEQUENTIAL
+		if (sequential)
+		{
+			posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+		}
+#else
+		(void)sequential;
+#endif
+
+		*handle = fd;
+		*size = size_t(info.st_size);
+		return true;
+#endif
+	}
+
+	void close_file(FileHandle handle)
+	{
+#ifdef _WIN32
+		CloseHandle(handle);
+#else
+		::close(handle);
+#endif
+	}
+
+	// One read for the whole file; the loop only continues if the OS hands out less than asked.
+	bool read_all(FileHandle handle, uint8_t* destination, size_t size)
+	{
+		size_t done = 0;
+
+		while (done != size)
+		{
+#ifdef _WIN32
+			DWORD request = DWORD(std::min<size_t>(size - done, 0x40000000));
+			DWORD received;
+
+			if (!ReadFile(handle, destination + done, request, &received, nullptr) || received == 0)
+			{
+				return false;
+			}
+#else
+			ssize_t received = pread(handle, destination + done, size - done, off_t(done));
+
+			if (received <= 0)
+			{
+				return false;
+			}
+#endif
+			done += size_t(received);
+		}
+
+		return true;
+	}
+
+	const uint8_t* map_all(FileHandle handle, size_t size)
+	{
+#ifdef _WIN32
+		HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+		if (mapping == nullptr)
+		{
+			return nullptr;
+		}
+
+		// The view keeps the mapping alive, so the handle can be closed right away
+		const uint8_t* result = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		CloseHandle(mapping);
+		return result;
+#else
+		void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, handle, 0);
+
+		return p != MAP_FAILED ? static_cast<const uint8_t*>(p) : nullptr;
+#endif
+	}
+
+	void unmap_all(const uint8_t* data, size_t size)
+	{
+#ifdef _WIN32
+		(void)size;
+		UnmapViewOfFile(data);
+#else
+		munmap(const_cast<uint8_t*>(data), size);
+#endif
+	}
+}
+
+
+bool read_file(const std::string& path, const std::function<uint8_t*(size_t)>& allocate, bool sequential)
+{
+	FileHandle handle;
+	size_t size;
+
+	if (!open_file(path, sequential, &handle, &size))
+	{
+		return false;
+	}
+
+	bool result = read_all(handle, allocate(size), size);
+	close_file(handle);
+
+	return result;
+}
+
+
+LoadedFile::LoadedFile()
+	: m_data(nullptr)
+	, m_size(0)
+	, m_mapped(false)
+{
+	// NOP
+}
+
+LoadedFile::~LoadedFile()
+{
+	release();
+}
+
+LoadedFile::LoadedFile(LoadedFile&& other)
+	: LoadedFile()
+{
+	*this = std::move(other);
+}
+
+LoadedFile& LoadedFile::operator =(LoadedFile&& other)
+{
+	if (this != &other)
+	{
+		release();
+
+		// Moving a vector keeps its heap block, so m_data stays valid for read contents too
+		m_copy = std::move(other.m_copy);
+		m_data = other.m_data;
+		m_size = other.m_size;
+		m_mapped = other.m_mapped;
+
+		other.m_data = nullptr;
+		other.m_size = 0;
+		other.m_mapped = false;
+		other.m_copy.clear();
+	}
+
+	return *this;
+}
+
+bool LoadedFile::open(const std::string& path, const FileLoadOptions& options)
+{
+	release();
+
+	FileHandle handle;
+	size_t size;
+
+	if (!open_file(path, options.sequential, &handle, &size))
+	{
+		return false;
+	}
+
+	bool result;
+
+	if (size != 0 && size >= options.map_threshold)
+	{
+		m_data = map_all(handle, size);
+		m_mapped = m_data != nullptr;
+		result = m_mapped;
+	}
+	else
+	{
+		m_copy.resize(size);
+		m_data = m_copy.data();
+		result = read_all(handle, m_copy.data(), size);
+	}
+
+	close_file(handle);
+
+	if (result)
+	{
+		m_size = size;
+	}
+	else
+	{
+		release();
+	}
+
+	return result;
+}
+
+void LoadedFile::release()
+{
+	if (m_mapped)
+	{
+		unmap_all(m_data, m_size);
+	}
+
+	m_copy.clear();
+	m_data = nullptr;
+	m_size = 0;
+	m_mapped = false;
+}
@@ -0,0 +1,62 @@
+#ifndef FILE_LOADER_H
+#define FILE_LOADER_H
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+struct FileLoadOptions
+{
+	FileLoadOptions() : map_threshold(1024 * 1024), sequential(true) { }
+
+	// Files of at least this many bytes are mapped into memory instead of read
+	size_t map_threshold;
+
+	// Tell the OS the file will be read front to back (posix_fadvise / FILE_FLAG_SEQUENTIAL_SCAN)
+	bool sequential;
+};
+
+
+/*
+	Reads a whole file with as few system calls as possible: open, fstat,
+	one pread straight into the memory returned by allocate(size), close.
+	allocate is called exactly once, also for empty files.
+	Returns false if the file cannot be opened or is shorter than reported.
+*/
+bool read_file(const std::string& path, const std::function<uint8_t*(size_t)>& allocate, bool sequential = true);
+
+
+/*
+	Owns the contents of a file loaded with read_file, or a read-only mapping
+	of it for files above FileLoadOptions::map_threshold. Small files are read
+	because a mapping costs more system calls (mmap, page faults, munmap) than
+	the single pread it saves.
+*/
+class LoadedFile
+{
+public:
+	LoadedFile();
+	~LoadedFile();
+
+	LoadedFile(LoadedFile&&);
+	LoadedFile& operator =(LoadedFile&&);
+
+	LoadedFile(const LoadedFile&) = delete;
+	LoadedFile& operator =(const LoadedFile&) = delete;
+
+	bool open(const std::string& path, const FileLoadOptions& options = FileLoadOptions());
+	void release();
+
+	const uint8_t* data() const { return m_data; }
+	size_t size() const { return m_size; }
+	bool mapped() const { return m_mapped; }
+
+private:
+	const uint8_t* m_data;
+	size_t m_size;
+	bool m_mapped;
+	std::vector<uint8_t> m_copy;
+};
+
+#endif
@@ -1,13 +1,14 @@
 #ifndef IO_H
 #define IO_H
 #include<sstream>
+#include<cstring>
 
 
 template<typename T>
 bool read(std::istream& in, T* x) {
 	int nr_of_bytes = sizeof(T);
 	char* buffer = reinterpret_cast<char*>(x);
-	
+
 	in.read(buffer, nr_of_bytes);
 
 	if (in) {
@@ -16,12 +17,160 @@ bool read(std::istream& in, T* x) {
 	else
 	{
 		return false;
-	}		
+	}
 }
 
 uint8_t read_byte(std::istream& in);
 
 uint32_t read_variable_length_integer(std::istream&);
 
-#endif
 
+/*
+	ByteCursor walks over a block of bytes that is already in memory (e.g. a MidiBuffer)
+	and offers the same read operations as the std::istream versions above, without
+	going through a streambuf for every value.
+
+	Like an istream, a cursor remembers when a read ran past the end:
+	the read returns false (or 0) and failed() becomes true.
+*/
+class ByteCursor
+{
+public:
+	ByteCursor() : m_position(nullptr), m_end(nullptr), m_failed(false) { }
+
+	ByteCursor(const uint8_t* begin, const uint8_t* end) : m_position(begin), m_end(end), m_failed(false) { }
+
+	ByteCursor(const uint8_t* begin, size_t size) : m_position(begin), m_end(begin + size), m_failed(false) { }
+
+	const uint8_t* position() const { return m_position; }
+
+	const uint8_t* end() const { return m_end; }
+
+	size_t remaining() const { return size_t(m_end - m_position); }
+
+	bool at_end() const { return m_position == m_end; }
+
+	bool failed() const { return m_failed; }
+
+	explicit operator bool() const { return !m_failed; }
+
+	void fail()
+	{
+		m_position = m_end;
+		m_failed = true;
+	}
+
+	// Returns the next n bytes and moves past them, or nullptr if there are not enough bytes left.
+	// Like an istream, a cursor that failed once keeps failing.
+	const uint8_t* take(size_t n)
+	{
+		if (m_failed || remaining() < n)
+		{
+			fail();
+			return nullptr;
+		}
+
+		const uint8_t* result = m_position;
+		m_position += n;
+		return result;
+	}
+
+	bool skip(size_t n)
+	{
+		return take(n) != nullptr;
+	}
+
+	// Splits off a cursor over the next n bytes and moves this cursor past them.
+	ByteCursor split(size_t n)
+	{
+		const uint8_t* begin = take(n);
+
+		if (begin == nullptr)
+		{
+			ByteCursor result;
+			result.fail();
+			return result;
+		}
+
+		return ByteCursor(begin, n);
+	}
+
+private:
+	const uint8_t* m_position;
+	const uint8_t* m_end;
+	bool m_failed;
+};
+
+template<typename T>
+bool read(ByteCursor& in, T* x) {
+	const uint8_t* bytes = in.take(sizeof(T));
+
+	if (bytes == nullptr)
+	{
+		return false;
+	}
+
+	std::memcpy(x, bytes, sizeof(T));
+	return true;
+}
+
+inline uint8_t read_byte(ByteCursor& in) {
+	const uint8_t* byte = in.take(1);
+
+	return byte != nullptr ? *byte : 0;
+}
+
+uint32_t read_long_variable_length_integer(ByteCursor&);
+
+/*
+	Nearly all delta times fit in one or two bytes, so those are decoded inline
+	without a loop. Anything longer (or too close to the end) takes the general path.
+*/
+inline uint32_t read_variable_length_integer(ByteCursor& in)
+{
+	if (in.remaining() >= 2)
+	{
+		const uint8_t* p = in.position();
+		uint32_t first = p[0];
+		uint32_t second = p[1];
+
+		if (first < 0x80)
+		{
+			in.skip(1);
+			return first;
+		}
+
+		if (second < 0x80)
+		{
+			in.skip(2);
+			return ((first & 0x7f) << 7) | second;
+		}
+	}
+
+	return read_long_variable_length_integer(in);
+}
+
+/*
+	Decodes a variable length integer and moves p past it, without any bounds checks.
+	Only for bytes that passed validate_mtrk_events.
+*/
+inline uint32_t read_variable_length_integer_unchecked(const uint8_t*& p)
+{
+	uint32_t result = *p & 0x7f;
+
+	while (*p++ & 0x80)
+	{
+		result = (result << 7) | (*p & 0x7f);
+	}
+
+	return result;
+}
+
+/*
+	Decodes up to count consecutive variable length integers and stores them in out.
+	Returns how many were decoded; fewer than count means the bytes ran out
+	(the cursor is marked as failed if the last integer was cut off).
+*/
+size_t read_variable_length_integers(ByteCursor& in, uint32_t* out, size_t count);
+
+#endif
@@ -0,0 +1,93 @@
+#include "midi-buffer.h"
+#include <utility>
+
+
+MidiBuffer::MidiBuffer()
+	: m_data(nullptr)
+	, m_size(0)
+{
+	// NOP
+}
+
+MidiBuffer::~MidiBuffer()
+{
+	release();
+}
+
+MidiBuffer::MidiBuffer(MidiBuffer&& other)
+	: MidiBuffer()
+{
+	*this = std::move(other);
+}
+
+MidiBuffer& MidiBuffer::operator =(MidiBuffer&& other)
+{
+	if (this != &other)
+	{
+		release();
+
+		// Moving a vector or a LoadedFile keeps its memory, so m_data stays valid
+		m_file = std::move(other.m_file);
+		m_copy = std::move(other.m_copy);
+		m_data = other.m_data;
+		m_size = other.m_size;
+
+		other.m_data = nullptr;
+		other.m_size = 0;
+		other.m_copy.clear();
+	}
+
+	return *this;
+}
+
+bool MidiBuffer::open(const std::string& path, const FileLoadOptions& options)
+{
+	release();
+
+	if (!m_file.open(path, options))
+	{
+		return false;
+	}
+
+	m_data = m_file.data();
+	m_size = m_file.size();
+
+	return true;
+}
+
+bool MidiBuffer::load(std::istream& in)
+{
+	release();
+
+	const size_t block_size = 64 * 1024;
+	size_t used = 0;
+
+	while (in)
+	{
+		m_copy.resize(used + block_size);
+		in.read(reinterpret_cast<char*>(m_copy.data() + used), block_size);
+		used += size_t(in.gcount());
+	}
+
+	m_copy.resize(used);
+	m_data = m_copy.data();
+	m_size = m_copy.size();
+
+	return !in.bad();
+}
+
+void MidiBuffer::view(const uint8_t* data, size_t size)
+{
+	release();
+
+	m_data = data;
+	m_size = size;
+}
+
+void MidiBuffer::release()
+{
+	m_file.release();
+	m_copy.clear();
+	m_data = nullptr;
+	m_size = 0;
+}
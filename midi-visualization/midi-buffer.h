@@ -0,0 +1,52 @@
+#ifndef MIDI_BUFFER_H
+#define MIDI_BUFFER_H
+#include "io.h"
+#include "file-loader.h"
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+
+/*
+	Holds the complete contents of a MIDI file as one contiguous block of bytes,
+	so that it can be parsed with a ByteCursor instead of an std::istream.
+
+	open() loads the file with a LoadedFile (a single read, or a mapping for
+	large files), load() copies whatever is left in an input stream. Either way, data() stays valid
+	until the buffer is destroyed or reused.
+
+	view() refers to bytes owned by someone else (e.g. an Arena); these must
+	outlive the buffer.
+*/
+class MidiBuffer
+{
+public:
+	MidiBuffer();
+	~MidiBuffer();
+
+	MidiBuffer(MidiBuffer&&);
+	MidiBuffer& operator =(MidiBuffer&&);
+
+	MidiBuffer(const MidiBuffer&) = delete;
+	MidiBuffer& operator =(const MidiBuffer&) = delete;
+
+	bool open(const std::string& path, const FileLoadOptions& options = FileLoadOptions());
+	bool load(std::istream& in);
+	void view(const uint8_t* data, size_t size);
+
+	const uint8_t* data() const { return m_data; }
+	size_t size() const { return m_size; }
+
+	ByteCursor cursor() const { return ByteCursor(m_data, m_size); }
+
+private:
+	void release();
+
+	LoadedFile m_file;
+	std::vector<uint8_t> m_copy;
+	const uint8_t* m_data;
+	size_t m_size;
+};
+
+#endif
@@ -4,6 +4,11 @@
 #include "endianness.h"
 #include<sstream>
 #include <type_traits>
+#include <memory>
+#include <vector>
+
+class MidiBuffer;
+struct VALIDATION_ERROR;
 
 struct CHUNK_HEADER
 {
@@ -30,13 +35,164 @@ struct NOTE
 };
 
 bool read_header(std::istream& in, CHUNK_HEADER* c);
+bool read_header(ByteCursor& in, CHUNK_HEADER* c);
 
 std::string header_id(const CHUNK_HEADER& c);
 
 bool read_mthd(std::istream& in, MThd* m);
+bool read_mthd(ByteCursor& in, MThd* m);
 
 bool operator ==(NOTE, NOTE);
 
 bool operator !=(NOTE, NOTE);
 
+
+/*
+	read_mtrk reports every event it finds in a track to an EventReceiver,
+	one method per kind of MIDI event. dt is the time since the previous event.
+
+	Meta and sysex payloads are passed as a pointer into the track data, which is only
+	valid during the call. A receiver that has no use for them can return false from
+	wants_meta()/wants_sysex(): their payloads are then skipped without being looked at,
+	and their dt is added to that of the next event the receiver does get.
+*/
+class EventReceiver
+{
+public:
+	virtual ~EventReceiver() { }
+
+	virtual bool wants_meta() const { return true; }
+	virtual bool wants_sysex() const { return true; }
+
+	virtual void note_on(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) = 0;
+	virtual void note_off(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) = 0;
+	virtual void polyphonic_key_pressure(uint32_t dt, uint8_t channel, uint8_t note, uint8_t pressure) = 0;
+	virtual void control_change(uint32_t dt, uint8_t channel, uint8_t controller, uint8_t value) = 0;
+	virtual void program_change(uint32_t dt, uint8_t channel, uint8_t program) = 0;
+	virtual void channel_pressure(uint32_t dt, uint8_t channel, uint8_t pressure) = 0;
+	virtual void pitch_wheel_change(uint32_t dt, uint8_t channel, uint16_t value) = 0;
+	virtual void meta(uint32_t dt, uint8_t type, const char* data, int data_size) = 0;
+	virtual void sysex(uint32_t dt, const char* data, int data_size) = 0;
+};
+
+/*
+	Pairs up note on and note off events on a single channel and
+	appends the resulting NOTEs (in note off order) to a vector.
+*/
+class NoteFilter final : public EventReceiver
+{
+public:
+	NoteFilter(uint8_t channel, std::vector<NOTE>* notes);
+
+	bool wants_meta() const override { return false; }
+	bool wants_sysex() const override { return false; }
+
+	void note_on(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) override;
+	void note_off(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) override;
+	void polyphonic_key_pressure(uint32_t dt, uint8_t channel, uint8_t note, uint8_t pressure) override;
+	void control_change(uint32_t dt, uint8_t channel, uint8_t controller, uint8_t value) override;
+	void program_change(uint32_t dt, uint8_t channel, uint8_t program) override;
+	void channel_pressure(uint32_t dt, uint8_t channel, uint8_t pressure) override;
+	void pitch_wheel_change(uint32_t dt, uint8_t channel, uint16_t value) override;
+	void meta(uint32_t dt, uint8_t type, const char* data, int data_size) override;
+	void sysex(uint32_t dt, const char* data, int data_size) override;
+
+private:
+	void end_note(uint8_t note);
+
+	uint8_t m_channel;
+	std::vector<NOTE>* m_notes;
+	uint32_t m_time;
+	uint32_t m_start[128];
+	bool m_playing[128];
+};
+
+/*
+	Does the work of 16 NoteFilters (one per channel) behind an EventMulticaster
+	in a single receiver: the pending notes of all channels live in one [16][128] table,
+	so every event costs one call and one table lookup instead of 16 calls.
+	Produces exactly the same NOTEs in the same order.
+*/
+class ChannelNoteCollector final : public EventReceiver
+{
+public:
+	explicit ChannelNoteCollector(std::vector<NOTE>* notes);
+
+	bool wants_meta() const override { return false; }
+	bool wants_sysex() const override { return false; }
+
+	void note_on(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) override;
+	void note_off(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) override;
+	void polyphonic_key_pressure(uint32_t dt, uint8_t channel, uint8_t note, uint8_t pressure) override { m_time += dt; }
+	void control_change(uint32_t dt, uint8_t channel, uint8_t controller, uint8_t value) override { m_time += dt; }
+	void program_change(uint32_t dt, uint8_t channel, uint8_t program) override { m_time += dt; }
+	void channel_pressure(uint32_t dt, uint8_t channel, uint8_t pressure) override { m_time += dt; }
+	void pitch_wheel_change(uint32_t dt, uint8_t channel, uint16_t value) override { m_time += dt; }
+	void meta(uint32_t dt, uint8_t type, const char* data, int data_size) override { m_time += dt; }
+	void sysex(uint32_t dt, const char* data, int data_size) override { m_time += dt; }
+
+private:
+	void end_note(uint8_t channel, uint8_t note);
+
+	std::vector<NOTE>* m_notes;
+	uint32_t m_time;
+	uint32_t m_start[16][128];
+	bool m_playing[16][128];
+};
+
+/*
+	Forwards every event it receives to each of the given receivers, in order.
+*/
+class EventMulticaster : public EventReceiver
+{
+public:
+	EventMulticaster(const std::vector<std::shared_ptr<EventReceiver>>& receivers);
+
+	bool wants_meta() const override;
+	bool wants_sysex() const override;
+
+	void note_on(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) override;
+	void note_off(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) override;
+	void polyphonic_key_pressure(uint32_t dt, uint8_t channel, uint8_t note, uint8_t pressure) override;
+	void control_change(uint32_t dt, uint8_t channel, uint8_t controller, uint8_t value) override;
+	void program_change(uint32_t dt, uint8_t channel, uint8_t program) override;
+	void channel_pressure(uint32_t dt, uint8_t channel, uint8_t pressure) override;
+	void pitch_wheel_change(uint32_t dt, uint8_t channel, uint16_t value) override;
+	void meta(uint32_t dt, uint8_t type, const char* data, int data_size) override;
+	void sysex(uint32_t dt, const char* data, int data_size) override;
+
+private:
+	std::vector<std::shared_ptr<EventReceiver>> m_receivers;
+};
+
+bool read_mtrk(std::istream& in, EventReceiver& receiver);
+bool read_mtrk(ByteCursor& in, EventReceiver& receiver);
+
+// Collects the notes of one MTrk chunk on all 16 channels.
+bool read_track_notes(ByteCursor& in, std::vector<NOTE>* notes);
+
+bool read_notes(std::istream& in, std::vector<NOTE>* notes);
+bool read_notes(const MidiBuffer& buffer, std::vector<NOTE>* notes);
+
+/*
+	Produces exactly the same notes as read_notes, but without going through
+	EventReceivers: note on/off events are paired in a tight loop and
+	every other event is skipped based on its length alone.
+
+	Each track is first checked with validate_mtrk_events, after which the
+	loop runs without any bounds checks. If the file is rejected and error
+	is not nullptr, it tells where the problem is (see mtrk-validator.h).
+*/
+bool read_track_notes_fast(ByteCursor& in, std::vector<NOTE>* notes);
+bool read_notes_fast(std::istream& in, std::vector<NOTE>* notes, VALIDATION_ERROR* error = nullptr);
+bool read_notes_fast(const MidiBuffer& buffer, std::vector<NOTE>* notes, VALIDATION_ERROR* error = nullptr);
+
+/*
+	Same result as read_notes, but the tracks of a format 1 file are decoded
+	on up to thread_count worker threads (0 = one per hardware thread).
+	Each track goes into its own vector; these are concatenated in track order,
+	so the output does not depend on scheduling.
+*/
+bool read_notes_parallel(const MidiBuffer& buffer, std::vector<NOTE>* notes, unsigned thread_count = 0);
+
 #endif
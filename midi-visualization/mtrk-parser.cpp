@@ -0,0 +1,255 @@
+#include "mtrk-parser.h"
+#include "event-table.h"
+#include <algorithm>
+#include <cstring>
+
+
+MtrkParser::MtrkParser(EventReceiver& receiver)
+	: m_receiver(receiver)
+{
+	reset();
+}
+
+void MtrkParser::reset()
+{
+	m_state = State::Header;
+	m_header_used = 0;
+	m_remaining = 0;
+	m_value = 0;
+	m_dt = 0;
+	m_running_status = 0;
+	m_status = 0;
+	m_data_used = 0;
+	m_data_needed = 0;
+	m_meta_type = 0;
+	m_length = 0;
+	m_received = 0;
+	m_deliver_meta = m_receiver.wants_meta();
+	m_deliver_sysex = m_receiver.wants_sysex();
+	m_deliver_payload = false;
+	m_skipped_dt = 0;
+	m_payload.clear();
+}
+
+MtrkParser::Status MtrkParser::status() const
+{
+	switch (m_state)
+	{
+	case State::Done:
+		return Status::Finished;
+	case State::Failed:
+		return Status::Error;
+	default:
+		return Status::NeedMoreData;
+	}
+}
+
+MtrkParser::Status MtrkParser::feed(const uint8_t* data, size_t size, size_t* consumed)
+{
+	size_t i = 0;
+
+	while (i != size && m_state != State::Done && m_state != State::Failed)
+	{
+		if (m_state == State::Header)
+		{
+			size_t n = std::min(sizeof(m_header) - m_header_used, size - i);
+			std::memcpy(m_header + m_header_used, data + i, n);
+			m_header_used += n;
+			i += n;
+
+			if (m_header_used == sizeof(m_header))
+			{
+				CHUNK_HEADER header;
+				ByteCursor cursor(m_header, sizeof(m_header));
+				read_header(cursor, &header);
+
+				m_remaining = header.size;
+				m_state = header_id(header) == "MTrk" ? State::DeltaTime : State::Failed;
+				m_value = 0;
+			}
+		}
+		else if (m_state == State::Payload)
+		{
+			size_t n = std::min(size_t(m_length - m_received), size - i);
+			m_remaining -= uint32_t(n);
+
+			if (!m_deliver_payload)
+			{
+				i += n;
+				m_received += uint32_t(n);
+
+				if (m_received == m_length)
+				{
+					payload_complete(nullptr);
+				}
+			}
+			else if (m_received == 0 && n == m_length)
+			{
+				// The whole payload is in this fragment: hand it over without copying
+				i += n;
+				payload_complete(data + i - n);
+			}
+			else
+			{
+				m_payload.insert(m_payload.end(), data + i, data + i + n);
+				i += n;
+				m_received += uint32_t(n);
+
+				if (m_received == m_length)
+				{
+					payload_complete(m_payload.data());
+				}
+			}
+		}
+		else if (m_remaining == 0)
+		{
+			// Chunk data ran out before the end of track event
+			m_state = State::Failed;
+		}
+		else
+		{
+			--m_remaining;
+			process_byte(data[i++]);
+		}
+	}
+
+	if (consumed != nullptr)
+	{
+		*consumed = i;
+	}
+
+	return status();
+}
+
+void MtrkParser::begin_variable_length_integer(State state)
+{
+	m_value = 0;
+	m_state = state;
+}
+
+void MtrkParser::begin_data(uint8_t status)
+{
+	m_status = status;
+	m_running_status = status;
+	m_data_used = 0;
+	m_data_needed = event_table[status].data_length;
+	m_state = State::Data;
+}
+
+void MtrkParser::process_byte(uint8_t byte)
+{
+	switch (m_state)
+	{
+	case State::DeltaTime:
+		m_value = (m_value << 7) | (byte & 0x7F);
+		if (!(byte & 0x80))
+		{
+			m_dt = m_value + m_skipped_dt;
+			m_skipped_dt = 0;
+			m_state = State::EventStatus;
+		}
+		break;
+
+	case State::EventStatus:
+	{
+		const EVENT_INFO& info = event_table[byte];
+
+		switch (info.event_class)
+		{
+		case EventClass::Data:
+			if (m_running_status == 0)
+			{
+				m_state = State::Failed;
+				break;
+			}
+
+			begin_data(m_running_status);
+			process_byte(byte);
+			break;
+		case EventClass::Meta:
+			m_status = byte;
+			m_state = State::MetaType;
+			break;
+		case EventClass::Sysex:
+			m_status = byte;
+			begin_variable_length_integer(State::Length);
+			break;
+		case EventClass::Invalid:
+			m_state = State::Failed;
+			break;
+		default:
+			begin_data(byte);
+			break;
+		}
+		break;
+	}
+
+	case State::Data:
+		m_data[m_data_used++] = byte;
+
+		if (m_data_used == m_data_needed)
+		{
+			dispatch_channel_event(m_receiver, event_table[m_status].event_class, m_dt, m_status, m_data[0], m_data[1]);
+			begin_variable_length_integer(State::DeltaTime);
+		}
+		break;
+
+	case State::MetaType:
+		m_meta_type = byte;
+		begin_variable_length_integer(State::Length);
+		break;
+
+	case State::Length:
+		m_value = (m_value << 7) | (byte & 0x7F);
+		if (!(byte & 0x80))
+		{
+			m_length = m_value;
+			m_received = 0;
+			m_deliver_payload = m_status == 0xFF ? m_deliver_meta : m_deliver_sysex;
+			m_payload.clear();
+
+			if (m_length > m_remaining)
+			{
+				m_state = State::Failed;
+			}
+			else if (m_length == 0)
+			{
+				payload_complete(nullptr);
+			}
+			else
+			{
+				m_state = State::Payload;
+			}
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+void MtrkParser::payload_complete(const uint8_t* data)
+{
+	const char* p = reinterpret_cast<const char*>(data);
+
+	if (!m_deliver_payload)
+	{
+		m_skipped_dt = m_dt;
+	}
+	else if (m_status == 0xFF)
+	{
+		m_receiver.meta(m_dt, m_meta_type, p, int(m_length));
+	}
+	else
+	{
+		m_receiver.sysex(m_dt, p, int(m_length));
+	}
+
+	if (m_status == 0xFF && m_meta_type == 0x2F)
+	{
+		m_state = m_remaining == 0 ? State::Done : State::Failed;
+		return;
+	}
+
+	begin_variable_length_integer(State::DeltaTime);
+}
@@ -0,0 +1,86 @@
+#ifndef MTRK_PARSER_H
+#define MTRK_PARSER_H
+#include "midi.h"
+#include <vector>
+
+
+/*
+	Push-style counterpart of read_mtrk for data that arrives in pieces
+	(a file that is still downloading, a sequencer that is still writing).
+
+	Give it the bytes of an MTrk chunk (header included) in fragments of any size.
+	Every event is passed to the receiver as soon as its last byte has arrived;
+	running status and half-read variable length integers carry over between calls.
+
+		MtrkParser parser(receiver);
+		while (more data)
+			if (parser.feed(data, size) != MtrkParser::Status::NeedMoreData) break;
+
+	The same rules as read_mtrk apply: the chunk must be an MTrk and must end
+	exactly with the end of track event. Meta and sysex payloads the receiver
+	does not want are skipped over without being buffered.
+*/
+class MtrkParser
+{
+public:
+	enum class Status
+	{
+		NeedMoreData,
+		Finished,
+		Error
+	};
+
+	explicit MtrkParser(EventReceiver& receiver);
+
+	// Bytes following the end of the chunk are not consumed; *consumed tells how many were.
+	Status feed(const uint8_t* data, size_t size, size_t* consumed = nullptr);
+
+	Status status() const;
+
+	// Prepares the parser for the next track.
+	void reset();
+
+private:
+	enum class State
+	{
+		Header,
+		DeltaTime,
+		EventStatus,
+		Data,
+		MetaType,
+		Length,
+		Payload,
+		Done,
+		Failed
+	};
+
+	void process_byte(uint8_t byte);
+	void begin_data(uint8_t status);
+	void begin_variable_length_integer(State state);
+	void payload_complete(const uint8_t* data);
+
+	EventReceiver& m_receiver;
+	State m_state;
+
+	uint8_t m_header[sizeof(CHUNK_HEADER)];
+	size_t m_header_used;
+	uint32_t m_remaining;
+
+	uint32_t m_value;
+	uint32_t m_dt;
+	uint8_t m_running_status;
+	uint8_t m_status;
+	uint8_t m_data[2];
+	unsigned m_data_used;
+	unsigned m_data_needed;
+	uint8_t m_meta_type;
+	uint32_t m_length;
+	uint32_t m_received;
+	bool m_deliver_meta;
+	bool m_deliver_sysex;
+	bool m_deliver_payload;
+	uint32_t m_skipped_dt;
+	std::vector<uint8_t> m_payload;
+};
+
+#endif
@@ -0,0 +1,211 @@
+#include "mtrk-validator.h"
+#include "chunk-index.h"
+#include "event-table.h"
+
+
+namespace
+{
+	bool fail(VALIDATION_ERROR* error, size_t offset, const char* reason)
+	{
+		if (error != nullptr)
+		{
+			error->offset = offset;
+			error->reason = reason;
+		}
+
+		return false;
+	}
+
+	// Moves i past a variable length integer. Returns false if it is longer than 4 bytes or cut off.
+	bool skip_variable_length_integer(const uint8_t* events, size_t size, size_t* i, uint32_t* value)
+	{
+		uint32_t result = 0;
+
+		for (size_t n = 0; n != 4; ++n)
+		{
+			if (*i == size)
+			{
+				return false;
+			}
+
+			uint8_t byte = events[(*i)++];
+			result = (result << 7) | (byte & 0x7f);
+
+			if ((byte & 0x80) == 0)
+			{
+				*value = result;
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
+
+
+bool validate_mtrk_events(const uint8_t* events, size_t size, VALIDATION_ERROR* error, size_t* note_ons)
+{
+	size_t i = 0;
+	uint8_t running_status = 0;
+	size_t note_on_count = 0;
+
+	while (true)
+	{
+		size_t event_start = i;
+		uint32_t value;
+
+		if (!skip_variable_length_integer(events, size, &i, &value))
+		{
+			return fail(error, event_start, "invalid delta time");
+		}
+
+		if (i == size)
+		{
+			return fail(error, i, "missing end of track");
+		}
+
+		size_t status_offset = i;
+		uint8_t status = events[i];
+		EVENT_INFO info = event_table[status];
+
+		if (info.event_class != EventClass::Data)
+		{
+			++i;
+		}
+		else if (running_status != 0)
+		{
+			status = running_status;
+			info = event_table[status];
+		}
+		else
+		{
+			return fail(error, status_offset, "data byte without running status");
+		}
+
+		if (info.running_status)
+		{
+			running_status = status;
+		}
+
+		if (info.event_class == EventClass::Meta)
+		{
+			if (i == size)
+			{
+				return fail(error, status_offset, "meta event cut off");
+			}
+
+			uint8_t type = events[i++];
+
+			if (!skip_variable_length_integer(events, size, &i, &value) || value > size - i)
+			{
+				return fail(error, status_offset, "meta event cut off");
+			}
+
+			i += value;
+
+			if (type == 0x2F)
+			{
+				if (i != size)
+				{
+					return fail(error, i, "data after end of track");
+				}
+
+				if (note_ons != nullptr)
+				{
+					*note_ons = note_on_count;
+				}
+
+				return true;
+			}
+		}
+		else if (info.event_class == EventClass::Sysex)
+		{
+			if (!skip_variable_length_integer(events, size, &i, &value) || value > size - i)
+			{
+				return fail(error, status_offset, "sysex event cut off");
+			}
+
+			i += value;
+		}
+		else if (info.event_class == EventClass::Invalid)
+		{
+			return fail(error, status_offset, "invalid status byte");
+		}
+		else
+		{
+			if (info.data_length > size - i)
+			{
+				return fail(error, status_offset, "channel event cut off");
+			}
+
+			if (info.event_class == EventClass::NoteOn && events[i + 1] != 0)
+			{
+				++note_on_count;
+			}
+
+			i += info.data_length;
+		}
+	}
+}
+
+bool validate_midi(const MidiBuffer& buffer, VALIDATION_ERROR* error, ChunkIndex* index_out, MThd* mthd_out, size_t* note_ons)
+{
+	size_t total_note_ons = 0;
+
+	ChunkIndex local_index;
+	MThd local_mthd;
+	ChunkIndex& index = index_out != nullptr ? *index_out : local_index;
+	MThd& mthd = mthd_out != nullptr ? *mthd_out : local_mthd;
+
+	if (!index.build(buffer))
+	{
+		// The chunk that is cut off starts right after the last complete one
+		size_t offset = 0;
+		if (!index.chunks().empty())
+		{
+			const CHUNK_ENTRY& last = index.chunks().back();
+			offset = last.offset + sizeof(CHUNK_HEADER) + last.header.size;
+		}
+
+		return fail(error, offset, "chunk cut off");
+	}
+
+	ByteCursor cursor = buffer.cursor();
+
+	if (index.header_chunk() == nullptr || !read_mthd(cursor, &mthd))
+	{
+		return fail(error, 0, "missing MThd");
+	}
+
+	if (index.track_count() < mthd.ntracks)
+	{
+		return fail(error, buffer.size(), "missing MTrk");
+	}
+
+	for (size_t i = 0; i != mthd.ntracks; ++i)
+	{
+		const CHUNK_ENTRY& entry = index.track_entry(i);
+		size_t offset = entry.offset + sizeof(CHUNK_HEADER);
+
+		size_t track_note_ons;
+
+		if (!validate_mtrk_events(buffer.data() + offset, entry.header.size, error, &track_note_ons))
+		{
+			if (error != nullptr)
+			{
+				error->offset += offset;
+			}
+
+			return false;
+		}
+
+		total_note_ons += track_note_ons;
+	}
+
+	if (note_ons != nullptr)
+	{
+		*note_ons = total_note_ons;
+	}
+
+	return true;
+}
@@ -0,0 +1,49 @@
+#ifndef MTRK_VALIDATOR_H
+#define MTRK_VALIDATOR_H
+#include "midi.h"
+#include "midi-buffer.h"
+#include "chunk-index.h"
+#include <cstdint>
+
+
+/*
+	Where and why validation failed. offset counts from the start of
+	whatever was passed to the validator (the events of one track for
+	validate_mtrk_events, the whole file for validate_midi).
+*/
+struct VALIDATION_ERROR
+{
+	size_t offset;
+	const char* reason;
+};
+
+
+/*
+	Walks over the events of one MTrk chunk (the size bytes after its header)
+	without decoding them, and checks that
+	- every variable length integer is at most 4 bytes long and ends inside the chunk,
+	- every event starts with a status byte or can use the running status,
+	- every data byte, meta payload and sysex payload lies inside the chunk,
+	- the chunk ends with the end of track meta event (0x2F) and nothing after it.
+
+	Events that pass can be decoded without any bounds checks; see
+	read_track_notes_fast. error may be nullptr.
+
+	If note_ons is not nullptr, it receives the number of note on events with a
+	velocity above 0. Every note starts with one of those, so it is an upper bound on
+	the notes of the track (exact unless some notes never end).
+*/
+bool validate_mtrk_events(const uint8_t* events, size_t size, VALIDATION_ERROR* error, size_t* note_ons = nullptr);
+
+/*
+	Validates the MThd chunk and the first ntracks MTrk chunks of a file.
+	Chunks after those, and chunks of unknown type, are not looked at.
+
+	The chunk index and MThd built along the way are stored in index and mthd
+	(either may be nullptr), so a decoder that runs next need not build them again.
+	Passing the same index for every file reuses its memory. note_ons, if not nullptr,
+	receives the note ons of all validated tracks (see validate_mtrk_events).
+*/
+bool validate_midi(const MidiBuffer& buffer, VALIDATION_ERROR* error, ChunkIndex* index = nullptr, MThd* mthd = nullptr, size_t* note_ons = nullptr);
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef NOTE_COLUMNS_H
+#define NOTE_COLUMNS_H
+#include "midi.h"
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+
+/*
+	Stores notes as four separate arrays (channel, note index, start, duration)
+	instead of one array of NOTEs, so that a pass that only needs one field only
+	reads that field. The reductions and filters below work directly on the
+	columns, with SSE2 where available (see simd.h).
+
+	operator[] and the iterators put a NOTE back together on the fly, so
+	code written for NOTEs can read a NoteColumns without a copy.
+*/
+class NoteColumns
+{
+public:
+	/*
+		Puts NOTEs together on the fly and returns them by value, so strictly speaking
+		it is only an input iterator (a forward iterator would have to return a NOTE&).
+		It does support every random access operation.
+	*/
+	class const_iterator
+	{
+	public:
+		// What operator-> returns: keeps the assembled NOTE alive for the member access
+		class arrow_proxy
+		{
+		public:
+			explicit arrow_proxy(const NOTE& note) : m_note(note) { }
+			const NOTE* operator ->() const { return &m_note; }
+
+		private:
+			NOTE m_note;
+		};
+
+		typedef std::input_iterator_tag iterator_category;
+		typedef NOTE value_type;
+		typedef ptrdiff_t difference_type;
+		typedef arrow_proxy pointer;
+		typedef NOTE reference;
+
+		const_iterator() : m_columns(nullptr), m_index(0) { }
+		const_iterator(const NoteColumns* columns, size_t index) : m_columns(columns), m_index(index) { }
+
+		NOTE operator *() const { return (*m_columns)[m_index]; }
+		arrow_proxy operator ->() const { return arrow_proxy(**this); }
+		NOTE operator [](difference_type n) const { return (*m_columns)[m_index + n]; }
+
+		const_iterator& operator ++() { ++m_index; return *this; }
+		const_iterator operator ++(int) { const_iterator old = *this; ++m_index; return old; }
+		const_iterator& operator --() { --m_index; return *this; }
+		const_iterator operator --(int) { const_iterator old = *this; --m_index; return old; }
+
+		const_iterator& operator +=(difference_type n) { m_index += n; return *this; }
+		const_iterator& operator -=(difference_type n) { m_index -= n; return *this; }
+		const_iterator operator +(difference_type n) const { return const_iterator(m_columns, m_index + n); }
+		const_iterator operator -(difference_type n) const { return const_iterator(m_columns, m_index - n); }
+		friend const_iterator operator +(difference_type n, const_iterator it) { return it + n; }
+		difference_type operator -(const_iterator other) const { return difference_type(m_index) - difference_type(other.m_index); }
+
+		bool operator ==(const_iterator other) const { return m_index == other.m_index; }
+		bool operator !=(const_iterator other) const { return m_index != other.m_index; }
+		bool operator <(const_iterator other) const { return m_index < other.m_index; }
+		bool operator >(const_iterator other) const { return m_index > other.m_index; }
+		bool operator <=(const_iterator other) const { return m_index <= other.m_index; }
+		bool operator >=(const_iterator other) const { return m_index >= other.m_index; }
+
+	private:
+		const NoteColumns* m_columns;
+		size_t m_index;
+	};
+
+	NoteColumns() { }
+	explicit NoteColumns(const std::vector<NOTE>& notes);
+
+	void reserve(size_t size);
+	void push_back(const NOTE& note);
+
+	size_t size() const { return m_starts.size(); }
+	bool empty() const { return m_starts.empty(); }
+
+	NOTE operator [](size_t index) const { return NOTE{ m_channels[index], m_note_indices[index], m_starts[index], m_durations[index] }; }
+
+	const_iterator begin() const { return const_iterator(this, 0); }
+	const_iterator end() const { return const_iterator(this, size()); }
+
+	const uint8_t* channels() const { return m_channels.data(); }
+	const uint8_t* note_indices() const { return m_note_indices.data(); }
+	const uint32_t* starts() const { return m_starts.data(); }
+	const uint32_t* durations() const { return m_durations.data(); }
+
+	void to_notes(std::vector<NOTE>* notes) const;
+
+	// Largest start + duration, i.e. when the last note ends (0 if there are no notes).
+	// 64 bit, because a note can end past 2^32.
+	uint64_t max_end() const;
+
+	// Lowest and highest note index; returns false if there are no notes
+	bool note_range(uint8_t* lowest, uint8_t* highest) const;
+
+	uint64_t total_duration() const;
+
+	void channel_histogram(uint32_t counts[16]) const;
+	void note_histogram(uint32_t counts[128]) const;
+
+	// The notes that pass a filter, in their original order
+	NoteColumns with_channel(uint8_t channel) const;
+	NoteColumns with_note_range(uint8_t lowest, uint8_t highest) const; // both inclusive
+	NoteColumns sounding_during(uint32_t from, uint32_t to) const; // start < to and start + duration > from, without wrapping around
+
+private:
+	NoteColumns select(const std::vector<uint32_t>& indices) const;
+
+	std::vector<uint8_t> m_channels;
+	std::vector<uint8_t> m_note_indices;
+	std::vector<uint32_t> m_starts;
+	std::vector<uint32_t> m_durations;
+};
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef NOTE_DECODER_H
+#define NOTE_DECODER_H
+#include "event-table.h"
+#include "io.h"
+
+
+/*
+	Walks over the events of one MTrk chunk, pairs note on and note off events
+	with the same rules as NoteFilter, and reports them to a handler:
+
+		handler.started(channel, note, time)           when a note starts sounding
+		handler.finished(channel, note, start, time)   when it stops (before a new start of the same note)
+
+	Notes still sounding at the end of track are not reported as finished;
+	for_each_sounding lists them.
+
+	The decoder can be driven one event at a time (step), which lets a caller
+	interleave several tracks, or run to the end of the track (decode_notes_unchecked).
+
+	The events must have passed validate_mtrk_events; nothing is checked here.
+*/
+class NoteDecoder
+{
+public:
+	// p points at the first delta time of the track.
+	explicit NoteDecoder(const uint8_t* p)
+		: m_position(p)
+		, m_running_status(0)
+		, m_playing{}
+	{
+		m_time = read_variable_length_integer_unchecked(m_position);
+	}
+
+	// Time of the event the next step handles.
+	uint32_t time() const { return m_time; }
+
+	// Handles one event. Returns false once the end of track event has been handled.
+	template<typename Handler>
+	bool step(Handler& handler)
+	{
+		const uint8_t*& p = m_position;
+		uint8_t status = *p;
+		EVENT_INFO info = event_table[status];
+
+		if (info.event_class != EventClass::Data)
+		{
+			++p;
+		}
+		else
+		{
+			status = m_running_status;
+			info = event_table[status];
+		}
+
+		if (info.event_class == EventClass::NoteOn || info.event_class == EventClass::NoteOff)
+		{
+			m_running_status = status;
+
+			uint8_t channel = status & 0x0F;
+			uint8_t note = p[0] & 0x7F;
+			uint8_t velocity = p[1];
+			p += 2;
+
+			// Same pairing rules as NoteFilter
+			if (m_playing[channel][note])
+			{
+				handler.finished(channel, note, m_start[channel][note], m_time);
+				m_playing[channel][note] = false;
+			}
+
+			if (info.event_class == EventClass::NoteOn && velocity != 0)
+			{
+				m_start[channel][note] = m_time;
+				m_playing[channel][note] = true;
+				handler.started(channel, note, m_time);
+			}
+		}
+		else if (info.running_status)
+		{
+			m_running_status = status;
+			p += info.data_length;
+		}
+		else if (info.event_class == EventClass::Meta)
+		{
+			uint8_t type = *p++;
+			p += read_variable_length_integer_unchecked(p);
+
+			if (type == 0x2F)
+			{
+				return false;
+			}
+		}
+		else
+		{
+			p += read_variable_length_integer_unchecked(p);
+		}
+
+		m_time += read_variable_length_integer_unchecked(p);
+		return true;
+	}
+
+	// Calls f(channel, note, start) for every note that is still sounding.
+	template<typename F>
+	void for_each_sounding(F f) const
+	{
+		for (unsigned channel = 0; channel != 16; ++channel)
+		{
+			for (unsigned note = 0; note != 128; ++note)
+			{
+				if (m_playing[channel][note])
+				{
+					f(uint8_t(channel), uint8_t(note), m_start[channel][note]);
+				}
+			}
+		}
+	}
+
+private:
+	const uint8_t* m_position;
+	uint32_t m_time;
+	uint8_t m_running_status;
+	uint32_t m_start[16][128];
+	bool m_playing[16][128];
+};
+
+// Decodes a whole track; p points at the first delta time.
+template<typename Handler>
+void decode_notes_unchecked(const uint8_t* p, Handler& handler)
+{
+	NoteDecoder decoder(p);
+
+	while (decoder.step(handler))
+	{
+		// NOP
+	}
+}
+
+#endif
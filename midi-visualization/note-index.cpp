@@ -0,0 +1,105 @@
+#include "note-index.h"
+#include <algorithm>
+#include <numeric>
+
+
+const uint32_t NoteIndex::none;
+
+
+NoteIndex::NoteIndex(const std::vector<NOTE>& notes)
+	: m_root(none)
+{
+	m_original.resize(notes.size());
+	std::iota(m_original.begin(), m_original.end(), 0u);
+	std::stable_sort(m_original.begin(), m_original.end(), [&notes](uint32_t a, uint32_t b) { return notes[a].start < notes[b].start; });
+
+	m_notes.reserve(notes.size());
+	for (uint32_t i : m_original)
+	{
+		m_notes.push_back(notes[i]);
+	}
+
+	std::vector<uint32_t> sounding;
+	for (uint32_t i = 0; i != m_notes.size(); ++i)
+	{
+		if (m_notes[i].duration != 0)
+		{
+			sounding.push_back(i);
+		}
+	}
+
+	m_by_start.reserve(sounding.size());
+	m_by_end.reserve(sounding.size());
+	m_root = build(sounding);
+}
+
+// positions must be sorted by start
+uint32_t NoteIndex::build(const std::vector<uint32_t>& positions)
+{
+	if (positions.empty())
+	{
+		return none;
+	}
+
+	// The median start: the note it belongs to sounds at the center, so every node holds at least one note
+	uint32_t center = m_notes[positions[positions.size() / 2]].start;
+	std::vector<uint32_t> left, right;
+	uint32_t begin = uint32_t(m_by_start.size());
+
+	for (uint32_t position : positions)
+	{
+		const NOTE& note = m_notes[position];
+
+		if (end_of(note) <= center)
+		{
+			left.push_back(position);
+		}
+		else if (note.start > center)
+		{
+			right.push_back(position);
+		}
+		else
+		{
+			m_by_start.push_back(position);
+			m_by_end.push_back(position);
+		}
+	}
+
+	uint32_t end = uint32_t(m_by_start.size());
+	std::stable_sort(m_by_end.begin() + begin, m_by_end.end(), [this](uint32_t a, uint32_t b) { return end_of(m_notes[a]) > end_of(m_notes[b]); });
+
+	uint32_t node = uint32_t(m_nodes.size());
+	m_nodes.push_back(NODE{ center, none, none, begin, end });
+
+	// Children are built after the node, so m_nodes may grow; only write through the index
+	uint32_t left_node = build(left);
+	uint32_t right_node = build(right);
+	m_nodes[node].left = left_node;
+	m_nodes[node].right = right_node;
+
+	return node;
+}
+
+size_t NoteIndex::first_start_after(uint32_t time) const
+{
+	auto first = std::upper_bound(m_notes.begin(), m_notes.end(), time, [](uint32_t t, const NOTE& note) { return t < note.start; });
+
+	return size_t(first - m_notes.begin());
+}
+
+void NoteIndex::overlapping(uint32_t from, uint32_t to, std::vector<NOTE>* out) const
+{
+	for_each_overlapping(from, to, [out](const NOTE& note, uint32_t) { out->push_back(note); });
+}
+
+void NoteIndex::overlapping_indices(uint32_t from, uint32_t to, std::vector<uint32_t>* out) const
+{
+	for_each_overlapping(from, to, [out](const NOTE&, uint32_t index) { out->push_back(index); });
+}
+
+size_t NoteIndex::count_overlapping(uint32_t from, uint32_t to) const
+{
+	size_t count = 0;
+	for_each_overlapping(from, to, [&count](const NOTE&, uint32_t) { ++count; });
+	return count;
+}
@@ -0,0 +1,123 @@
+#ifndef NOTE_INDEX_H
+#define NOTE_INDEX_H
+#include "midi.h"
+#include <cstdint>
+#include <vector>
+
+
+/*
+	Answers "which notes sound during [from, to)?" without scanning every note.
+	A note overlaps the window if start < to and start + duration > from, with
+	the end in 64 bits (the same rule as NoteColumns::sounding_during).
+
+	Such a note either already sounds at from (start <= from < end), or it starts
+	inside the window (from < start < to). The second kind is a range of the notes
+	sorted by start, found with a binary search. The first kind comes from a
+	centered interval tree: every node has a center, holds the notes that sound at
+	it, and passes the notes that end before it to its left child and the ones that
+	start after it to its right child. A node keeps its notes sorted by start and by
+	end, so it is scanned only up to the first note that does not sound at from,
+	and only one child needs to be visited. With the median start as center the
+	tree is O(log n) deep, so a query costs O(log n + k) for k results.
+
+	Building takes O(n log n) time and O(n) memory. Notes with a duration of 0 are
+	left out of the tree, as they never sound at any time.
+
+	Results come out in two groups: first the notes that already sound at from
+	(in no particular order), then the ones that start inside the window, in order
+	of start (ties: order in the original vector).
+*/
+class NoteIndex
+{
+public:
+	NoteIndex() : m_root(none) { }
+	explicit NoteIndex(const std::vector<NOTE>& notes);
+
+	size_t size() const { return m_notes.size(); }
+	bool empty() const { return m_notes.empty(); }
+
+	// Appends the overlapping notes to out.
+	void overlapping(uint32_t from, uint32_t to, std::vector<NOTE>* out) const;
+
+	// Appends the positions (in the vector given to the constructor) of the overlapping notes to out.
+	void overlapping_indices(uint32_t from, uint32_t to, std::vector<uint32_t>* out) const;
+
+	size_t count_overlapping(uint32_t from, uint32_t to) const;
+
+	template<typename Callback>
+	void for_each_overlapping(uint32_t from, uint32_t to, Callback&& callback) const
+	{
+		if (from >= to)
+		{
+			return;
+		}
+
+		// Sounding at from: walk down the tree towards from
+		for (uint32_t node = m_root; node != none; )
+		{
+			const NODE& n = m_nodes[node];
+
+			if (from < n.center)
+			{
+				// Every note here ends after the center, so it sounds at from if it has started
+				for (uint32_t i = n.begin; i != n.end && m_notes[m_by_start[i]].start <= from; ++i)
+				{
+					report(m_by_start[i], callback);
+				}
+
+				node = n.left;
+			}
+			else
+			{
+				// Every note here starts at or before the center, so it sounds at from if it has not ended
+				for (uint32_t i = n.begin; i != n.end && end_of(m_notes[m_by_end[i]]) > from; ++i)
+				{
+					report(m_by_end[i], callback);
+				}
+
+				node = n.right;
+			}
+		}
+
+		// Starting inside the window
+		for (size_t i = first_start_after(from); i != m_notes.size() && m_notes[i].start < to; ++i)
+		{
+			report(uint32_t(i), callback);
+		}
+	}
+
+	// The notes sorted by start
+	const std::vector<NOTE>& notes() const { return m_notes; }
+
+private:
+	static const uint32_t none = 0xFFFFFFFFu;
+
+	struct NODE
+	{
+		uint32_t center;
+		uint32_t left;
+		uint32_t right;
+		uint32_t begin; // The node's notes are [begin, end) in m_by_start and in m_by_end
+		uint32_t end;
+	};
+
+	static uint64_t end_of(const NOTE& note) { return uint64_t(note.start) + note.duration; }
+
+	template<typename Callback>
+	void report(uint32_t position, Callback& callback) const
+	{
+		callback(m_notes[position], m_original[position]);
+	}
+
+	size_t first_start_after(uint32_t time) const;
+	uint32_t build(const std::vector<uint32_t>& positions);
+
+	std::vector<NOTE> m_notes;
+	std::vector<uint32_t> m_original;
+	std::vector<NODE> m_nodes;
+	std::vector<uint32_t> m_by_start; // Positions in m_notes, per node sorted by start
+	std::vector<uint32_t> m_by_end;   // The same positions, per node sorted by end, latest first
+	uint32_t m_root;
+};
+
+#endif
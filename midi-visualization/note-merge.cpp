@@ -0,0 +1,207 @@
+#include "note-merge.h"
+#include "chunk-index.h"
+#include "mtrk-validator.h"
+#include "note-decoder.h"
+#include <algorithm>
+
+
+namespace
+{
+	// Places each note when it starts, so the notes end up sorted by start
+	class StartOrderCollector
+	{
+	public:
+		StartOrderCollector(std::vector<NOTE>* notes) : m_notes(notes) { }
+
+		void started(uint8_t channel, uint8_t note, uint32_t time)
+		{
+			m_index[channel][note] = m_notes->size();
+			m_notes->push_back(NOTE{ channel, note, time, 0 });
+			m_open.push_back(true);
+		}
+
+		void finished(uint8_t channel, uint8_t note, uint32_t start, uint32_t end)
+		{
+			size_t index = m_index[channel][note];
+
+			(*m_notes)[index].duration = end - start;
+			m_open[index] = false;
+		}
+
+		// Notes that never ended are dropped, like NoteFilter does
+		void remove_open_notes()
+		{
+			size_t kept = 0;
+
+			for (size_t i = 0; i != m_notes->size(); ++i)
+			{
+				if (!m_open[i])
+				{
+					(*m_notes)[kept++] = (*m_notes)[i];
+				}
+			}
+
+			m_notes->resize(kept);
+		}
+
+	private:
+		std::vector<NOTE>* m_notes;
+		std::vector<bool> m_open;
+		size_t m_index[16][128];
+	};
+}
+
+
+NoteMerger::NoteMerger(const std::vector<NOTE_RUN>& runs)
+	: m_runs(runs)
+	, m_losers(runs.size())
+	, m_winner(0)
+{
+	size_t k = m_runs.size();
+
+	if (k < 2)
+	{
+		return;
+	}
+
+	// Play the initial tournament bottom up; leaf i sits at position k + i
+	std::vector<size_t> winners(2 * k);
+
+	for (size_t i = 0; i != k; ++i)
+	{
+		winners[k + i] = i;
+	}
+
+	for (size_t n = k - 1; n != 0; --n)
+	{
+		size_t a = winners[2 * n];
+		size_t b = winners[2 * n + 1];
+
+		if (beats(b, a))
+		{
+			std::swap(a, b);
+		}
+
+		winners[n] = a;
+		m_losers[n] = b;
+	}
+
+	m_winner = winners[1];
+}
+
+bool NoteMerger::beats(size_t a, size_t b) const
+{
+	const NOTE_RUN& x = m_runs[a];
+	const NOTE_RUN& y = m_runs[b];
+
+	if (x.begin == x.end)
+	{
+		return false;
+	}
+
+	if (y.begin == y.end)
+	{
+		return true;
+	}
+
+	return x.begin->start < y.begin->start || (x.begin->start == y.begin->start && a < b);
+}
+
+void NoteMerger::pop()
+{
+	++m_runs[m_winner].begin;
+
+	size_t winner = m_winner;
+
+	for (size_t n = (m_runs.size() + winner) / 2; n != 0; n /= 2)
+	{
+		if (beats(m_losers[n], winner))
+		{
+			std::swap(m_losers[n], winner);
+		}
+	}
+
+	m_winner = winner;
+}
+
+size_t NoteMerger::read(NOTE* out, size_t max)
+{
+	size_t count = 0;
+
+	while (count != max && !empty())
+	{
+		out[count++] = top();
+		pop();
+	}
+
+	return count;
+}
+
+void merge_note_runs(const std::vector<NOTE_RUN>& runs, std::vector<NOTE>* notes)
+{
+	size_t total = 0;
+	for (auto& run : runs)
+	{
+		total += size_t(run.end - run.begin);
+	}
+
+	size_t offset = notes->size();
+	notes->resize(offset + total);
+
+	NoteMerger merger(runs);
+	merger.read(notes->data() + offset, total);
+}
+
+void merge_note_runs(const std::vector<NOTE_RUN>& runs, NoteSink& sink, size_t batch_size)
+{
+	std::vector<NOTE> batch(std::max<size_t>(1, batch_size));
+	NoteMerger merger(runs);
+	size_t count;
+
+	while ((count = merger.read(batch.data(), batch.size())) != 0)
+	{
+		sink.notes(batch.data(), count);
+	}
+}
+
+bool read_track_runs(const MidiBuffer& buffer, std::vector<std::vector<NOTE>>* runs)
+{
+	ChunkIndex index;
+	MThd mthd;
+
+	if (!validate_midi(buffer, nullptr, &index, &mthd))
+	{
+		return false;
+	}
+
+	runs->resize(mthd.ntracks);
+
+	for (size_t i = 0; i != mthd.ntracks; ++i)
+	{
+		StartOrderCollector collector(&(*runs)[i]);
+
+		decode_notes_unchecked(index.chunk_data(index.track_entry(i)).position(), collector);
+		collector.remove_open_notes();
+	}
+
+	return true;
+}
+
+bool read_notes_sorted(const MidiBuffer& buffer, std::vector<NOTE>* notes)
+{
+	std::vector<std::vector<NOTE>> tracks;
+
+	if (!read_track_runs(buffer, &tracks))
+	{
+		return false;
+	}
+
+	std::vector<NOTE_RUN> runs;
+	for (auto& track : tracks)
+	{
+		runs.push_back(NOTE_RUN{ track.data(), track.data() + track.size() });
+	}
+
+	merge_note_runs(runs, notes);
+	return true;
+}
@@ -0,0 +1,63 @@
+#ifndef NOTE_MERGE_H
+#define NOTE_MERGE_H
+#include "midi.h"
+#include "midi-buffer.h"
+#include "note-stream.h"
+#include <vector>
+
+
+// A range of notes sorted by start.
+struct NOTE_RUN
+{
+	const NOTE* begin;
+	const NOTE* end;
+};
+
+
+/*
+	Merges k runs into one sequence sorted by start using a loser tree:
+	every internal node remembers the loser of the match played there, so after
+	taking the overall winner only the path from its run to the root is
+	replayed, i.e. log2(k) comparisons per note. Notes with the same start
+	come out in run order, so the merge is stable.
+*/
+class NoteMerger
+{
+public:
+	explicit NoteMerger(const std::vector<NOTE_RUN>& runs);
+
+	bool empty() const { return m_runs.empty() || m_runs[m_winner].begin == m_runs[m_winner].end; }
+
+	const NOTE& top() const { return *m_runs[m_winner].begin; }
+
+	void pop();
+
+	// Moves up to max notes to out and returns how many there were.
+	size_t read(NOTE* out, size_t max);
+
+private:
+	bool beats(size_t a, size_t b) const;
+
+	std::vector<NOTE_RUN> m_runs;
+	std::vector<size_t> m_losers; // m_losers[n] is the loser at internal node n (1 .. k-1)
+	size_t m_winner;
+};
+
+void merge_note_runs(const std::vector<NOTE_RUN>& runs, std::vector<NOTE>* notes);
+void merge_note_runs(const std::vector<NOTE_RUN>& runs, NoteSink& sink, size_t batch_size = 4096);
+
+/*
+	Reads the notes of every track in order of start (ties: order of note on)
+	instead of note off order: a note gets its place in the vector when it
+	starts and its duration when it ends. One vector per track.
+*/
+bool read_track_runs(const MidiBuffer& buffer, std::vector<std::vector<NOTE>>* runs);
+
+/*
+	The notes of read_notes, sorted by start across all tracks
+	(ties: track order, then order of note on; the same order as stream_notes), without a full sort:
+	read_track_runs followed by merge_note_runs.
+*/
+bool read_notes_sorted(const MidiBuffer& buffer, std::vector<NOTE>* notes);
+
+#endif
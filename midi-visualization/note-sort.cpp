@@ -0,0 +1,191 @@
+#include "note-sort.h"
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+
+namespace
+{
+	const unsigned key_bytes = 6;
+
+	// The 6 key bytes as one integer, least significant byte first: note_index, channel, start
+	uint64_t key_of(const NOTE& note)
+	{
+		return (uint64_t(note.start) << 16) | (uint32_t(note.channel) << 8) | note.note_index;
+	}
+
+	uint8_t key_byte(const NOTE& note, unsigned byte)
+	{
+		return uint8_t(key_of(note) >> (8 * byte));
+	}
+
+	typedef size_t Histogram[256];
+
+	void count(const NOTE* begin, const NOTE* end, Histogram* histograms)
+	{
+		for (const NOTE* note = begin; note != end; ++note)
+		{
+			++histograms[0][note->note_index];
+			++histograms[1][note->channel];
+			++histograms[2][note->start & 0xFF];
+			++histograms[3][(note->start >> 8) & 0xFF];
+			++histograms[4][(note->start >> 16) & 0xFF];
+			++histograms[5][note->start >> 24];
+		}
+	}
+
+	// A pass is useless if every note has the same value for this byte
+	bool is_trivial(const Histogram& histogram, size_t size)
+	{
+		for (unsigned digit = 0; digit != 256; ++digit)
+		{
+			if (histogram[digit] != 0)
+			{
+				return histogram[digit] == size;
+			}
+		}
+
+		return true;
+	}
+
+	void scatter(const NOTE* begin, const NOTE* end, NOTE* out, unsigned byte, size_t* offsets)
+	{
+		for (const NOTE* note = begin; note != end; ++note)
+		{
+			out[offsets[key_byte(*note, byte)]++] = *note;
+		}
+	}
+}
+
+
+void radix_sort_notes(std::vector<NOTE>& notes)
+{
+	size_t size = notes.size();
+	Histogram histograms[key_bytes] = {};
+
+	count(notes.data(), notes.data() + size, histograms);
+
+	std::vector<NOTE> buffer(size);
+	NOTE* from = notes.data();
+	NOTE* to = buffer.data();
+
+	for (unsigned byte = 0; byte != key_bytes; ++byte)
+	{
+		if (is_trivial(histograms[byte], size))
+		{
+			continue;
+		}
+
+		size_t offsets[256];
+		size_t total = 0;
+
+		for (unsigned digit = 0; digit != 256; ++digit)
+		{
+			offsets[digit] = total;
+			total += histograms[byte][digit];
+		}
+
+		scatter(from, from + size, to, byte, offsets);
+		std::swap(from, to);
+	}
+
+	if (from != notes.data())
+	{
+		std::copy(from, from + size, notes.data());
+	}
+}
+
+void radix_sort_notes_parallel(std::vector<NOTE>& notes, unsigned thread_count)
+{
+	if (thread_count == 0)
+	{
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	// Small arrays are not worth starting threads for
+	size_t size = notes.size();
+	thread_count = unsigned(std::min<size_t>(thread_count, size / 65536 + 1));
+
+	if (thread_count == 1)
+	{
+		radix_sort_notes(notes);
+		return;
+	}
+
+	auto slice_begin = [size, thread_count](unsigned t) { return size * t / thread_count; };
+
+	auto run_on_all_threads = [thread_count](const std::function<void(unsigned)>& work) {
+		std::vector<std::thread> threads;
+		for (unsigned t = 1; t != thread_count; ++t)
+		{
+			threads.emplace_back(work, t);
+		}
+		work(0);
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+	};
+
+	// Totals per key byte do not change when the notes are moved around, so they are counted once
+	std::vector<std::vector<size_t>> histograms(thread_count, std::vector<size_t>(key_bytes * 256));
+
+	run_on_all_threads([&](unsigned t) {
+		count(notes.data() + slice_begin(t), notes.data() + slice_begin(t + 1), reinterpret_cast<Histogram*>(histograms[t].data()));
+	});
+
+	Histogram totals[key_bytes] = {};
+	for (unsigned t = 0; t != thread_count; ++t)
+	{
+		for (unsigned i = 0; i != key_bytes * 256; ++i)
+		{
+			totals[i / 256][i % 256] += histograms[t][i];
+		}
+	}
+
+	std::vector<NOTE> buffer(size);
+	NOTE* from = notes.data();
+	NOTE* to = buffer.data();
+	std::vector<std::vector<size_t>> offsets(thread_count, std::vector<size_t>(256));
+
+	for (unsigned byte = 0; byte != key_bytes; ++byte)
+	{
+		if (is_trivial(totals[byte], size))
+		{
+			continue;
+		}
+
+		// Which notes are in a slice changes with every pass, so the slices are counted again
+		run_on_all_threads([&](unsigned t) {
+			std::fill(offsets[t].begin(), offsets[t].end(), 0);
+
+			for (const NOTE* note = from + slice_begin(t); note != from + slice_begin(t + 1); ++note)
+			{
+				++offsets[t][key_byte(*note, byte)];
+			}
+		});
+
+		// Thread t writes its notes with a given digit after those of threads 0 .. t-1, which keeps the pass stable
+		size_t position = 0;
+		for (unsigned digit = 0; digit != 256; ++digit)
+		{
+			for (unsigned t = 0; t != thread_count; ++t)
+			{
+				size_t count = offsets[t][digit];
+				offsets[t][digit] = position;
+				position += count;
+			}
+		}
+
+		run_on_all_threads([&](unsigned t) {
+			scatter(from + slice_begin(t), from + slice_begin(t + 1), to, byte, offsets[t].data());
+		});
+
+		std::swap(from, to);
+	}
+
+	if (from != notes.data())
+	{
+		std::copy(from, from + size, notes.data());
+	}
+}
@@ -0,0 +1,28 @@
+#ifndef NOTE_SORT_H
+#define NOTE_SORT_H
+#include "midi.h"
+#include <vector>
+
+
+/*
+	Sorts notes by (start, channel, note_index) with an LSD radix sort: one
+	counting pass per key byte, least significant first, each one stable.
+	The key is 6 bytes (note_index, channel, then the 4 bytes of start) and
+	all 6 histograms are built in a single pass up front. A byte that is the
+	same for every note (e.g. the top byte of start in all but very long
+	files) needs no pass at all.
+
+	Notes with equal keys keep their order, like std::stable_sort.
+	Uses a second buffer as big as notes.
+*/
+void radix_sort_notes(std::vector<NOTE>& notes);
+
+/*
+	Same result as radix_sort_notes. Every pass is split over thread_count
+	threads (0 = one per hardware thread): each thread counts its own slice,
+	and the per-thread counts give every thread a private range to scatter
+	into, so no synchronisation is needed within a pass.
+*/
+void radix_sort_notes_parallel(std::vector<NOTE>& notes, unsigned thread_count = 0);
+
+#endif
@@ -0,0 +1,195 @@
+#include "note-stream.h"
+#include "chunk-index.h"
+#include "note-decoder.h"
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+	struct PENDING_NOTE
+	{
+		NOTE note;
+		size_t track;
+		uint64_t sequence;
+	};
+
+	// Orders the priority queue so that the earliest start comes out first (ties: track, then order of note on)
+	struct StartsLater
+	{
+		bool operator ()(const PENDING_NOTE& a, const PENDING_NOTE& b) const
+		{
+			return std::tie(a.note.start, a.track, a.sequence) > std::tie(b.note.start, b.track, b.sequence);
+		}
+	};
+
+	class NoteStreamer
+	{
+	public:
+		NoteStreamer(NoteSink& sink, size_t window)
+			: m_sink(sink)
+			, m_window(std::max<size_t>(1, window))
+			, m_sequence(0)
+		{
+			m_batch.reserve(std::min<size_t>(m_window, 4096));
+		}
+
+		// Returns the note's sequence number, which note_finished needs
+		uint64_t note_started(uint32_t start)
+		{
+			m_sounding.insert(start);
+			return m_sequence++;
+		}
+
+		void note_finished(size_t track, const NOTE& note, uint64_t sequence)
+		{
+			m_sounding.erase(m_sounding.find(note.start));
+			m_pending.push(PENDING_NOTE{ note, track, sequence });
+
+			if (m_pending.size() > m_window)
+			{
+				emit_next();
+			}
+		}
+
+		void note_dropped(uint32_t start)
+		{
+			m_sounding.erase(m_sounding.find(start));
+		}
+
+		// No note that is still to come or still sounding starts before time
+		void release(uint32_t time)
+		{
+			if (!m_sounding.empty())
+			{
+				time = std::min(time, *m_sounding.begin());
+			}
+
+			while (!m_pending.empty() && m_pending.top().note.start < time)
+			{
+				emit_next();
+			}
+		}
+
+		void finish()
+		{
+			while (!m_pending.empty())
+			{
+				emit_next();
+			}
+
+			flush();
+		}
+
+	private:
+		void emit_next()
+		{
+			m_batch.push_back(m_pending.top().note);
+			m_pending.pop();
+
+			if (m_batch.size() == m_window)
+			{
+				flush();
+			}
+		}
+
+		void flush()
+		{
+			if (!m_batch.empty())
+			{
+				m_sink.notes(m_batch.data(), m_batch.size());
+				m_batch.clear();
+			}
+		}
+
+		NoteSink& m_sink;
+		size_t m_window;
+		uint64_t m_sequence;
+		std::multiset<uint32_t> m_sounding;
+		std::priority_queue<PENDING_NOTE, std::vector<PENDING_NOTE>, StartsLater> m_pending;
+		std::vector<NOTE> m_batch;
+	};
+
+	// Passes the notes of one track's NoteDecoder on to the streamer
+	class TrackHandler
+	{
+	public:
+		TrackHandler(NoteStreamer& streamer, size_t track) : m_streamer(streamer), m_track(track) { }
+
+		void started(uint8_t channel, uint8_t note, uint32_t time)
+		{
+			m_sequence[channel][note] = m_streamer.note_started(time);
+		}
+
+		void finished(uint8_t channel, uint8_t note, uint32_t start, uint32_t end)
+		{
+			m_streamer.note_finished(m_track, NOTE{ channel, note, start, end - start }, m_sequence[channel][note]);
+		}
+
+	private:
+		NoteStreamer& m_streamer;
+		size_t m_track;
+		uint64_t m_sequence[16][128];
+	};
+
+	struct TRACK_STATE
+	{
+		TRACK_STATE(const uint8_t* events, NoteStreamer& streamer, size_t track) : decoder(events), handler(streamer, track) { }
+
+		NoteDecoder decoder;
+		TrackHandler handler;
+	};
+}
+
+
+bool stream_notes(const MidiBuffer& buffer, NoteSink& sink, size_t window, VALIDATION_ERROR* error)
+{
+	ChunkIndex index;
+	MThd mthd;
+
+	if (!validate_midi(buffer, error, &index, &mthd))
+	{
+		return false;
+	}
+
+	NoteStreamer streamer(sink, window);
+	std::vector<TRACK_STATE> tracks;
+	typedef std::pair<uint32_t, size_t> NEXT_EVENT; // time and track
+	std::priority_queue<NEXT_EVENT, std::vector<NEXT_EVENT>, std::greater<NEXT_EVENT>> next_events;
+
+	tracks.reserve(mthd.ntracks);
+	for (size_t i = 0; i != mthd.ntracks; ++i)
+	{
+		tracks.emplace_back(index.chunk_data(index.track_entry(i)).position(), streamer, i);
+		next_events.push(NEXT_EVENT(tracks[i].decoder.time(), i));
+	}
+
+	while (!next_events.empty())
+	{
+		size_t i = next_events.top().second;
+		next_events.pop();
+
+		TRACK_STATE& track = tracks[i];
+		uint32_t time = track.decoder.time();
+
+		if (track.decoder.step(track.handler))
+		{
+			next_events.push(NEXT_EVENT(track.decoder.time(), i));
+		}
+		else
+		{
+			// Notes that never got a note off are dropped, like NoteFilter does
+			track.decoder.for_each_sounding([&streamer](uint8_t, uint8_t, uint32_t start) { streamer.note_dropped(start); });
+		}
+
+		streamer.release(next_events.empty() ? time : next_events.top().first);
+	}
+
+	streamer.finish();
+	return true;
+}
@@ -0,0 +1,40 @@
+#ifndef NOTE_STREAM_H
+#define NOTE_STREAM_H
+#include "midi.h"
+#include "midi-buffer.h"
+#include "mtrk-validator.h"
+#include <cstddef>
+
+
+/*
+	Receives the notes of stream_notes in batches. The batch is only valid during the call.
+*/
+class NoteSink
+{
+public:
+	virtual ~NoteSink() { }
+
+	virtual void notes(const NOTE* notes, size_t count) = 0;
+};
+
+/*
+	Extracts the same notes as read_notes, but hands them to sink in batches of
+	(at most) window notes instead of collecting the whole file, in the same order
+	as read_notes_sorted: by start, notes with the same start in track order and
+	within a track in order of note on.
+
+	All tracks are decoded side by side, always advancing the one whose next event
+	comes first. A finished note is held back as long as a note that started earlier
+	is still sounding, because that one has to come out first. Memory is therefore
+	bounded by the notes still sounding plus window held-back notes plus one batch.
+
+	If more than window notes pile up behind a note that keeps sounding, the oldest
+	of them are let through anyway, so the long note comes out later than its start
+	would say. With a window of a few thousand notes that only happens for notes
+	that are held for a very long time (e.g. a note off that is missing).
+
+	The file is validated first; if it is rejected, nothing is sent to sink.
+*/
+bool stream_notes(const MidiBuffer& buffer, NoteSink& sink, size_t window = 4096, VALIDATION_ERROR* error = nullptr);
+
+#endif
@@ -0,0 +1,124 @@
+#include "packed-notes.h"
+#include <algorithm>
+
+
+namespace
+{
+	const int64_t smallest_offset = -(int64_t(1) << 25) + 1;
+	const int64_t largest_offset = (int64_t(1) << 25) - 1;
+	const uint32_t largest_duration = (uint32_t(1) << 27) - 1;
+
+	// The most negative offset is never used for a real note; it marks an exception
+	const uint64_t exception_bits = uint64_t(uint64_t(1) << 25) << 11;
+
+	PackedNote pack(uint8_t channel, uint8_t note_index, int64_t offset, uint32_t duration)
+	{
+		uint64_t bits = uint64_t(channel)
+			| (uint64_t(note_index) << 4)
+			| ((uint64_t(offset) & 0x3FFFFFF) << 11)
+			| (uint64_t(duration) << 37);
+
+		return PackedNote{ bits };
+	}
+
+	bool is_exception(PackedNote packed)
+	{
+		return (packed.bits & (uint64_t(0x3FFFFFF) << 11)) == exception_bits;
+	}
+}
+
+
+PackedNotes::PackedNotes(const std::vector<NOTE>& notes)
+{
+	m_notes.reserve(notes.size());
+	m_block_starts.reserve(notes.size() / block_size + 1);
+
+	for (auto& note : notes)
+	{
+		push_back(note);
+	}
+}
+
+void PackedNotes::push_back(const NOTE& note)
+{
+	size_t index = m_notes.size();
+
+	if (index % block_size == 0)
+	{
+		m_block_starts.push_back(note.start);
+	}
+
+	int64_t offset = int64_t(note.start) - int64_t(m_block_starts.back());
+
+	bool fits = note.channel <= 0xF && note.note_index <= 0x7F
+		&& offset >= smallest_offset && offset <= largest_offset
+		&& note.duration <= largest_duration;
+
+	if (fits)
+	{
+		m_notes.push_back(pack(note.channel, note.note_index, offset, note.duration));
+	}
+	else
+	{
+		m_notes.push_back(PackedNote{ exception_bits });
+		m_exceptions.push_back(EXCEPTION{ uint32_t(index), note });
+	}
+}
+
+NOTE PackedNotes::unpack(size_t index, PackedNote packed) const
+{
+	if (is_exception(packed))
+	{
+		auto it = std::lower_bound(m_exceptions.begin(), m_exceptions.end(), index, [](const EXCEPTION& e, size_t i) {
+			return e.index < i;
+		});
+
+		return it->note;
+	}
+
+	uint32_t start = uint32_t(int64_t(m_block_starts[index / block_size]) + packed.start_offset());
+
+	return NOTE{ packed.channel(), packed.note_index(), start, packed.duration() };
+}
+
+NOTE PackedNotes::operator [](size_t index) const
+{
+	return unpack(index, m_notes[index]);
+}
+
+void PackedNotes::unpack(std::vector<NOTE>* notes) const
+{
+	notes->reserve(notes->size() + m_notes.size());
+
+	for (size_t block = 0; block != m_block_starts.size(); ++block)
+	{
+		int64_t block_start = m_block_starts[block];
+		size_t end = std::min(m_notes.size(), (block + 1) * block_size);
+
+		for (size_t i = block * block_size; i != end; ++i)
+		{
+			PackedNote packed = m_notes[i];
+
+			if (is_exception(packed))
+			{
+				notes->push_back(unpack(i, packed));
+			}
+			else
+			{
+				notes->push_back(NOTE{ packed.channel(), packed.note_index(), uint32_t(block_start + packed.start_offset()), packed.duration() });
+			}
+		}
+	}
+}
+
+std::vector<NOTE> PackedNotes::unpack() const
+{
+	std::vector<NOTE> notes;
+	unpack(&notes);
+	return notes;
+}
+
+size_t PackedNotes::memory_usage() const
+{
+	return m_notes.size() * sizeof(PackedNote) + m_block_starts.size() * sizeof(uint32_t) + m_exceptions.size() * sizeof(EXCEPTION);
+}
@@ -0,0 +1,80 @@
+#ifndef PACKED_NOTES_H
+#define PACKED_NOTES_H
+#include "midi.h"
+#include <cstdint>
+#include <vector>
+
+
+/*
+	A NOTE in 8 bytes instead of 12:
+
+		bits  0 ..  3   channel
+		bits  4 .. 10   note index
+		bits 11 .. 36   start, relative to the start of the block the note is in (signed)
+		bits 37 .. 63   duration
+
+	A PackedNote only means something together with its PackedNotes container,
+	which knows the block starts.
+*/
+struct PackedNote
+{
+	uint64_t bits;
+
+	uint8_t channel() const { return uint8_t(bits & 0xF); }
+	uint8_t note_index() const { return uint8_t((bits >> 4) & 0x7F); }
+	int32_t start_offset() const { return int32_t(int64_t(bits << 27) >> 38); }
+	uint32_t duration() const { return uint32_t(bits >> 37); }
+};
+
+static_assert(sizeof(PackedNote) == 8, "PackedNote must fit in 8 bytes");
+
+
+/*
+	Sequence of notes stored as PackedNotes. Notes are grouped in blocks of
+	block_size; every block remembers the start of its first note and the other
+	starts are stored as the difference to it, which for notes in (roughly)
+	start order is small.
+
+	A note that does not fit (start more than 2^25 ticks away from the block
+	start, duration of 2^27 ticks or more, channel above 15 or note index above 127) is stored
+	whole in a separate exception list, so converting back gives exactly the
+	NOTEs that went in, in the same order.
+*/
+class PackedNotes
+{
+public:
+	static const size_t block_size = 256;
+
+	PackedNotes() { }
+	explicit PackedNotes(const std::vector<NOTE>& notes);
+
+	void push_back(const NOTE& note);
+
+	NOTE operator [](size_t index) const;
+
+	size_t size() const { return m_notes.size(); }
+	bool empty() const { return m_notes.empty(); }
+
+	void unpack(std::vector<NOTE>* notes) const;
+	std::vector<NOTE> unpack() const;
+
+	// Bytes used by the notes, block starts and exceptions (not counting unused capacity)
+	size_t memory_usage() const;
+
+	size_t exception_count() const { return m_exceptions.size(); }
+
+private:
+	struct EXCEPTION
+	{
+		uint32_t index;
+		NOTE note;
+	};
+
+	NOTE unpack(size_t index, PackedNote packed) const;
+
+	std::vector<PackedNote> m_notes;
+	std::vector<uint32_t> m_block_starts;
+	std::vector<EXCEPTION> m_exceptions; // sorted by index
+};
+
+#endif
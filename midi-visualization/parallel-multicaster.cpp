@@ -0,0 +1,211 @@
+#include "parallel-multicaster.h"
+
+
+namespace
+{
+	const unsigned spins_before_yielding = 64;
+	const unsigned spins_before_sleeping = 256;
+
+	// Spins, then yields, then gives up; returns whether done() came true in time
+	template<typename Done>
+	bool spin_until(Done done)
+	{
+		for (unsigned attempts = 0; attempts != spins_before_sleeping; ++attempts)
+		{
+			if (done())
+			{
+				return true;
+			}
+
+			if (attempts >= spins_before_yielding)
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		return false;
+	}
+
+	// Sleeps on wakeup until done() comes true; done() is checked with the mutex held, so a wake() cannot slip in between
+	template<typename Done>
+	void sleep_until(std::mutex& mutex, std::condition_variable& wakeup, Done done)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		wakeup.wait(lock, done);
+	}
+
+	// Call after making done() true
+	void wake(std::mutex& mutex, std::condition_variable& wakeup)
+	{
+		// Taking the mutex once makes sure the sleeper is either still before its last look or already waiting
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+		}
+		wakeup.notify_one();
+	}
+}
+
+
+ParallelEventMulticaster::ParallelEventMulticaster(const std::vector<std::shared_ptr<EventReceiver>>& receivers, size_t block_size, size_t block_count)
+	: m_block_size(block_size < 1 ? 1 : block_size)
+	, m_current(0)
+	, m_current_ready(false)
+	, m_wants_meta(false)
+	, m_wants_sysex(false)
+{
+	block_count = block_count < 2 ? 2 : block_count;
+
+	for (size_t i = 0; i != block_count; ++i)
+	{
+		m_blocks.emplace_back(new Block());
+		m_blocks.back()->events.reserve(m_block_size);
+		m_blocks.back()->readers = 0;
+	}
+
+	for (auto& receiver : receivers)
+	{
+		// Room for every block plus the stop signal, so publishing never has to wait for a queue
+		m_workers.emplace_back(new Worker(receiver, block_count + 1));
+		m_wants_meta = m_wants_meta || receiver->wants_meta();
+		m_wants_sysex = m_wants_sysex || receiver->wants_sysex();
+	}
+
+	for (auto& worker : m_workers)
+	{
+		Worker& w = *worker;
+		w.thread = std::thread([this, &w]() { run(w); });
+	}
+}
+
+ParallelEventMulticaster::~ParallelEventMulticaster()
+{
+	wait();
+
+	for (auto& worker : m_workers)
+	{
+		send(*worker, nullptr);
+		worker->thread.join();
+	}
+}
+
+ParallelEventMulticaster::Block& ParallelEventMulticaster::current_block()
+{
+	Block& block = *m_blocks[m_current];
+
+	if (!m_current_ready)
+	{
+		// The workers take the blocks in the same order as they are published, so this is the one the slowest worker still needs the longest
+		wait_until_free(block);
+
+		block.events.clear();
+		block.payload.clear();
+		m_current_ready = true;
+	}
+
+	return block;
+}
+
+void ParallelEventMulticaster::add(uint32_t dt, unsigned status, uint8_t d1, uint8_t d2, const char* payload, uint32_t payload_size)
+{
+	Block& block = current_block();
+
+	block.events.push_back(QUEUED_EVENT{ dt, payload_size, uint8_t(status), d1, d2 });
+	block.payload.insert(block.payload.end(), payload, payload + payload_size);
+
+	if (block.events.size() == m_block_size)
+	{
+		publish();
+	}
+}
+
+void ParallelEventMulticaster::meta(uint32_t dt, uint8_t type, const char* data, int data_size)
+{
+	add(dt, 0xFF, type, 0, data, uint32_t(data_size));
+}
+
+void ParallelEventMulticaster::sysex(uint32_t dt, const char* data, int data_size)
+{
+	add(dt, 0xF0, 0, 0, data, uint32_t(data_size));
+}
+
+void ParallelEventMulticaster::publish()
+{
+	if (!m_current_ready || m_blocks[m_current]->events.empty())
+	{
+		return;
+	}
+
+	Block* block = m_blocks[m_current].get();
+	block->readers.store(m_workers.size(), std::memory_order_relaxed);
+
+	// The queue's release store makes the block's contents visible to the worker
+	for (auto& worker : m_workers)
+	{
+		send(*worker, block);
+	}
+
+	m_current = (m_current + 1) % m_blocks.size();
+	m_current_ready = false;
+}
+
+void ParallelEventMulticaster::wait()
+{
+	publish();
+
+	for (auto& block : m_blocks)
+	{
+		wait_until_free(*block);
+	}
+}
+
+void ParallelEventMulticaster::wait_until_free(Block& block)
+{
+	auto free = [&block]() { return block.readers.load(std::memory_order_acquire) == 0; };
+
+	if (!spin_until(free))
+	{
+		sleep_until(m_block_free_mutex, m_block_free, free);
+	}
+}
+
+void ParallelEventMulticaster::send(Worker& worker, Block* block)
+{
+	worker.blocks.push(block);
+	wake(worker.mutex, worker.wakeup);
+}
+
+void ParallelEventMulticaster::run(Worker& worker)
+{
+	EventReceiver& receiver = *worker.receiver;
+	Block* block;
+
+	for (;;)
+	{
+		auto received = [&worker, &block]() { return worker.blocks.try_pop(&block); };
+
+		if (!spin_until(received))
+		{
+			sleep_until(worker.mutex, worker.wakeup, received);
+		}
+
+		if (block == nullptr)
+		{
+			return;
+		}
+
+		const uint8_t* payload = block->payload.data();
+
+		// Like EventMulticaster, every receiver gets every event, including meta/sysex it did not ask for
+		for (const QUEUED_EVENT& event : block->events)
+		{
+			deliver_queued_event(event, payload, receiver);
+			payload += event.payload_size;
+		}
+
+		// The last reader wakes the decoder, in case it is waiting for this block
+		if (block->readers.fetch_sub(1, std::memory_order_release) == 1)
+		{
+			wake(m_block_free_mutex, m_block_free);
+		}
+	}
+}
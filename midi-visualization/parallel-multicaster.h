@@ -0,0 +1,99 @@
+#ifndef PARALLEL_MULTICASTER_H
+#define PARALLEL_MULTICASTER_H
+#include "midi.h"
+#include "event-queue.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/*
+	Concurrent counterpart of EventMulticaster: every receiver runs on a worker
+	thread of its own, so expensive receivers no longer wait for each other.
+
+	The decoding thread writes events (and copies of meta/sysex payloads) into a
+	block. A full block is published once: a pointer to it goes into every worker's
+	SpscQueue and the block is not touched again until all workers are done with it.
+	Each worker hands the events of the blocks to its receiver in order, so every
+	receiver sees exactly the calls it would get from an EventMulticaster.
+
+	A fixed ring of blocks is reused; when the slowest worker is block_count blocks
+	behind, the decoder waits for it.
+
+	Waiting spins and yields only briefly. After that an idle worker sleeps on its
+	condition variable until the next block is published, and a decoder that is held
+	back sleeps until the last worker lets go of the block it needs.
+
+	Receivers are only called from their worker, so receivers must not share
+	unguarded state (e.g. NoteFilters appending to one vector). Call wait() before looking at their
+	results: it publishes the partly filled block and returns when every worker has
+	handled everything. The destructor does the same and stops the workers.
+*/
+class ParallelEventMulticaster final : public EventReceiver
+{
+public:
+	ParallelEventMulticaster(const std::vector<std::shared_ptr<EventReceiver>>& receivers, size_t block_size = 256, size_t block_count = 8);
+	~ParallelEventMulticaster();
+
+	ParallelEventMulticaster(const ParallelEventMulticaster&) = delete;
+	ParallelEventMulticaster& operator =(const ParallelEventMulticaster&) = delete;
+
+	bool wants_meta() const override { return m_wants_meta; }
+	bool wants_sysex() const override { return m_wants_sysex; }
+
+	void note_on(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) override { add(dt, 0x90 | channel, note, velocity); }
+	void note_off(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) override { add(dt, 0x80 | channel, note, velocity); }
+	void polyphonic_key_pressure(uint32_t dt, uint8_t channel, uint8_t note, uint8_t pressure) override { add(dt, 0xA0 | channel, note, pressure); }
+	void control_change(uint32_t dt, uint8_t channel, uint8_t controller, uint8_t value) override { add(dt, 0xB0 | channel, controller, value); }
+	void program_change(uint32_t dt, uint8_t channel, uint8_t program) override { add(dt, 0xC0 | channel, program, 0); }
+	void channel_pressure(uint32_t dt, uint8_t channel, uint8_t pressure) override { add(dt, 0xD0 | channel, pressure, 0); }
+	void pitch_wheel_change(uint32_t dt, uint8_t channel, uint16_t value) override { add(dt, 0xE0 | channel, uint8_t(value & 0xFF), uint8_t(value >> 8)); }
+	void meta(uint32_t dt, uint8_t type, const char* data, int data_size) override;
+	void sysex(uint32_t dt, const char* data, int data_size) override;
+
+	// Publishes the events so far and waits until every receiver has handled them.
+	void wait();
+
+private:
+	struct Block
+	{
+		std::vector<QUEUED_EVENT> events;
+		std::vector<uint8_t> payload; // The payloads of the meta/sysex events, one after the other
+		std::atomic<size_t> readers;  // Workers that have not finished this block yet
+	};
+
+	struct Worker
+	{
+		Worker(std::shared_ptr<EventReceiver> receiver, size_t queue_capacity) : receiver(receiver), blocks(queue_capacity) { }
+
+		std::shared_ptr<EventReceiver> receiver;
+		SpscQueue<Block*> blocks; // nullptr tells the worker to stop
+		std::mutex mutex;         // Only guards sleeping on wakeup, not the queue
+		std::condition_variable wakeup;
+		std::thread thread;
+	};
+
+	void add(uint32_t dt, unsigned status, uint8_t d1, uint8_t d2, const char* payload = nullptr, uint32_t payload_size = 0);
+	void publish();
+	Block& current_block();
+	void wait_until_free(Block& block);
+	static void send(Worker& worker, Block* block);
+	void run(Worker& worker);
+
+	std::vector<std::unique_ptr<Block>> m_blocks;
+	std::vector<std::unique_ptr<Worker>> m_workers;
+	size_t m_block_size;
+	size_t m_current;
+	bool m_current_ready;
+	bool m_wants_meta;
+	bool m_wants_sysex;
+
+	// The decoder sleeps on m_block_free while a block it needs is still being read
+	std::mutex m_block_free_mutex;
+	std::condition_variable m_block_free;
+};
+
+#endif
@@ -0,0 +1,57 @@
+#include "parse-context.h"
+#include "file-loader.h"
+
+
+ParseContext::ParseContext(size_t initial_size)
+	: m_arena(initial_size)
+	, m_notes(ArenaAllocator<NOTE>(m_arena))
+{
+	// NOP
+}
+
+bool ParseContext::load(const std::string& path)
+{
+	reset();
+
+	uint8_t* data = nullptr;
+	size_t size = 0;
+
+	bool loaded = read_file(path, [this, &data, &size](size_t file_size) {
+		size = file_size;
+		data = static_cast<uint8_t*>(m_arena.allocate(file_size, 1));
+		return data;
+	});
+
+	if (!loaded)
+	{
+		return false;
+	}
+
+	m_buffer.view(data, size);
+	return true;
+}
+
+void ParseContext::use(MidiBuffer&& buffer)
+{
+	reset();
+	m_buffer = std::move(buffer);
+}
+
+bool ParseContext::read_notes(VALIDATION_ERROR* error)
+{
+	// read_notes_fast reserves for the note ons it counts while validating, so the notes never grow
+	return read_notes_fast(m_buffer, &m_notes, &m_index, error);
+}
+
+bool ParseContext::read_notes(const std::string& path, VALIDATION_ERROR* error)
+{
+	return load(path) && read_notes(error);
+}
+
+void ParseContext::reset()
+{
+	// The vector's storage lives in the arena, so it has to let go of it before the arena is reset
+	ArenaVector<NOTE>(ArenaAllocator<NOTE>(m_arena)).swap(m_notes);
+	m_buffer.view(nullptr, 0);
+	m_arena.reset();
+}
@@ -0,0 +1,64 @@
+#ifndef PARSE_CONTEXT_H
+#define PARSE_CONTEXT_H
+#include "arena.h"
+#include "midi.h"
+#include "midi-buffer.h"
+#include "mtrk-validator.h"
+#include "chunk-index.h"
+#include <string>
+
+
+/*
+	Everything that parsing one file allocates comes from a single Arena:
+	the file contents and the note array. The note array is reserved up front
+	for the note ons that validation counts (every note starts with one), so it
+	never grows. Reading the next file resets the arena in one go instead of
+	freeing piece by piece. The chunk index is kept from file to file, so once
+	its vectors are big enough, parsing does not allocate outside the arena either.
+
+	A context is meant to be reused: keep one per worker thread. Its memory
+	grows to what the biggest file so far needed and then stays there: the file
+	size plus 12 bytes (one NOTE) per note on. A note on takes at least 3 bytes,
+	so that is never more than 5 times the biggest file, and for real files
+	usually less than twice.
+
+	A file opened elsewhere (e.g. mapped by MidiBuffer::open) can be handed over
+	with use(); then only the notes are in the arena.
+*/
+class ParseContext
+{
+public:
+	explicit ParseContext(size_t initial_size = 256 * 1024);
+
+	ParseContext(const ParseContext&) = delete;
+	ParseContext& operator =(const ParseContext&) = delete;
+
+	// Resets the context and reads the whole file into the arena; see buffer().
+	bool load(const std::string& path);
+
+	// Resets the context and parses the given buffer instead of a file read into the arena.
+	void use(MidiBuffer&& buffer);
+
+	// Extracts the notes of the loaded file, with the same result as read_notes_fast.
+	bool read_notes(VALIDATION_ERROR* error = nullptr);
+
+	// load and read_notes in one. The buffer and notes stay valid until the next load or reset.
+	bool read_notes(const std::string& path, VALIDATION_ERROR* error = nullptr);
+
+	const ArenaVector<NOTE>& notes() const { return m_notes; }
+	const MidiBuffer& buffer() const { return m_buffer; }
+	Arena& arena() { return m_arena; }
+
+	void reset();
+
+private:
+	Arena m_arena;
+	MidiBuffer m_buffer;
+	ArenaVector<NOTE> m_notes;
+	ChunkIndex m_index;
+};
+
+// read_notes_fast that builds the chunk index in the given one, reusing its memory.
+bool read_notes_fast(const MidiBuffer& buffer, ArenaVector<NOTE>* notes, ChunkIndex* index, VALIDATION_ERROR* error = nullptr);
+
+#endif
@@ -1,4 +1,5 @@
 #include "io.h"
+#include "simd.h"
 
 uint32_t read_variable_length_integer(std::istream& in)
 {
@@ -19,4 +20,143 @@ uint32_t read_variable_length_integer(std::istream& in)
 	return result;
 
 
-}         
\ No newline at end of file
+}         
+
+uint32_t read_long_variable_length_integer(ByteCursor& in)
+{
+	uint8_t byte = read_byte(in);
+	uint32_t result = byte & 0x7f;
+
+	while ((byte & 0x80) && in)
+	{
+		byte = read_byte(in);
+		result = (result << 7) | (byte & 0x7f);
+	}
+	return result;
+}
+
+
+namespace
+{
+	unsigned lowest_set_bit(uint32_t mask)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return unsigned(index);
+#else
+		return unsigned(__builtin_ctz(mask));
+#endif
+	}
+
+	/*
+		Decodes every integer that ends inside bytes[0..width). bit i of 'continuation'
+		is set if bytes[i] has its most significant bit set, i.e. if the integer goes on.
+		Returns the number of bytes consumed (0 if no integer ends within the block).
+	*/
+	size_t decode_block(const uint8_t* bytes, uint32_t continuation, unsigned width, uint32_t* out, size_t count, size_t* decoded)
+	{
+		uint32_t terminators = ~continuation & uint32_t((uint64_t(1) << width) - 1);
+		unsigned start = 0;
+
+		while (terminators != 0 && *decoded != count)
+		{
+			unsigned end = lowest_set_bit(terminators);
+			terminators &= terminators - 1;
+
+			uint32_t result = 0;
+			for (unsigned i = start; i <= end; ++i)
+			{
+				result = (result << 7) | (bytes[i] & 0x7f);
+			}
+
+			out[(*decoded)++] = result;
+			start = end + 1;
+		}
+
+		return start;
+	}
+
+#ifdef MIDI_USE_SSE2
+	// Widens 16 bytes, all known to be below 0x80, into 16 uint32_t values.
+	void widen_16(__m128i bytes, uint32_t* out)
+	{
+		__m128i zero = _mm_setzero_si128();
+		__m128i low = _mm_unpacklo_epi8(bytes, zero);
+		__m128i high = _mm_unpackhi_epi8(bytes, zero);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 0), _mm_unpacklo_epi16(low, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_unpackhi_epi16(low, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpacklo_epi16(high, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12), _mm_unpackhi_epi16(high, zero));
+	}
+#endif
+}
+
+size_t read_variable_length_integers(ByteCursor& in, uint32_t* out, size_t count)
+{
+	size_t decoded = 0;
+
+#if defined(MIDI_USE_AVX2)
+	while (count - decoded >= 32 && in.remaining() >= 32)
+	{
+		const uint8_t* p = in.position();
+		__m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+		uint32_t continuation = uint32_t(_mm256_movemask_epi8(bytes));
+
+		if (continuation == 0)
+		{
+			widen_16(_mm256_castsi256_si128(bytes), out + decoded);
+			widen_16(_mm256_extracti128_si256(bytes, 1), out + decoded + 16);
+			decoded += 32;
+			in.skip(32);
+			continue;
+		}
+
+		size_t consumed = decode_block(p, continuation, 32, out, count, &decoded);
+		if (consumed == 0)
+		{
+			break;
+		}
+		in.skip(consumed);
+	}
+#endif
+
+#if defined(MIDI_USE_SSE2)
+	while (count - decoded >= 16 && in.remaining() >= 16)
+	{
+		const uint8_t* p = in.position();
+		__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		uint32_t continuation = uint32_t(_mm_movemask_epi8(bytes));
+
+		if (continuation == 0)
+		{
+			widen_16(bytes, out + decoded);
+			decoded += 16;
+			in.skip(16);
+			continue;
+		}
+
+		size_t consumed = decode_block(p, continuation, 16, out, count, &decoded);
+		if (consumed == 0)
+		{
+			break;
+		}
+		in.skip(consumed);
+	}
+#endif
+
+	while (decoded != count && !in.at_end())
+	{
+		uint32_t result = read_variable_length_integer(in);
+
+		if (!in)
+		{
+			break;
+		}
+
+		out[decoded++] = result;
+	}
+
+	return decoded;
+}
@@ -1,19 +1,29 @@
 #include "midi.h"
 #include "endianness.h"
+#include <cstddef>
 
-bool read_mthd(std::istream& in, MThd* mthd) {
-	bool result;
-	result = read(in, mthd);
-
-	if (header_id(mthd->header) != "MThd")
-		//|| (mthd->header.size != sizeof(in))
+bool read_mthd(ByteCursor& in, MThd* mthd) {
+	if (in.remaining() < sizeof(MThd))
 	{
-		result = false;
+		in.fail();
+		return false;
 	}
-	switch_endianness(&mthd->header.size);
-	switch_endianness(&mthd->type);
-	switch_endianness(&mthd->ntracks);
-	switch_endianness(&mthd->division);
 
-	return result;
+	const uint8_t* bytes = in.position();
+	read_header(in, &mthd->header);
+	in.skip(sizeof(MThd) - sizeof(CHUNK_HEADER));
+
+	mthd->type = load_be16(bytes + offsetof(MThd, type));
+	mthd->ntracks = load_be16(bytes + offsetof(MThd, ntracks));
+	mthd->division = load_be16(bytes + offsetof(MThd, division));
+
+	return header_id(mthd->header) == "MThd";
+}
+
+bool read_mthd(std::istream& in, MThd* mthd) {
+	uint8_t bytes[sizeof(MThd)];
+	in.read(reinterpret_cast<char*>(bytes), sizeof(bytes));
+
+	ByteCursor cursor(bytes, size_t(in.gcount()));
+	return read_mthd(cursor, mthd);
 }
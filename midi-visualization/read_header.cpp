@@ -1,17 +1,26 @@
 #include "midi.h"
 #include "endianness.h"
+#include <cstddef>
+#include <cstring>
 
 
+bool read_header(ByteCursor& in, CHUNK_HEADER* header) {
+	const uint8_t* bytes = in.take(sizeof(CHUNK_HEADER));
+
+	if (bytes == nullptr)
+	{
+		return false;
+	}
+
+	std::memcpy(header->id, bytes + offsetof(CHUNK_HEADER, id), sizeof(header->id));
+	header->size = load_be32(bytes + offsetof(CHUNK_HEADER, size));
+	return true;
+}
+
 bool read_header(std::istream& in, CHUNK_HEADER* header) {
-	//char buffer[] = { 'M', 'T', 'h', 'd', 0, 0, 0, 0 };
-	//std::string data(read_variable_length_integer(in), sizeof(in));
-	//std::stringstream ss(data);
+	uint8_t bytes[sizeof(CHUNK_HEADER)];
+	in.read(reinterpret_cast<char*>(bytes), sizeof(bytes));
 
-	//uint32_t b = read_variable_length_integer(ss);
-	//header = reinterpret_cast<CHUNK_HEADER*>(buffer);
-	
-	bool result = read(in, header);
-	switch_endianness(&header->size);
-	return result;
-	//return read(in, c);
-}
\ No newline at end of file
+	ByteCursor cursor(bytes, size_t(in.gcount()));
+	return read_header(cursor, header);
+}
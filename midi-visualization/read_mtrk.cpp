@@ -0,0 +1,39 @@
+#include "midi.h"
+#include "static-receivers.h"
+#include <algorithm>
+
+
+bool read_mtrk(ByteCursor& in, EventReceiver& receiver)
+{
+	return read_mtrk<EventReceiver>(in, receiver);
+}
+
+bool read_mtrk(std::istream& in, EventReceiver& receiver)
+{
+	CHUNK_HEADER header;
+
+	if (!read_header(in, &header) || header_id(header) != "MTrk")
+	{
+		return false;
+	}
+
+	// Grow the buffer as data arrives rather than trusting the size up front
+	const size_t block_size = 64 * 1024;
+	std::vector<uint8_t> data;
+
+	while (data.size() != header.size)
+	{
+		size_t used = data.size();
+		size_t n = std::min(block_size, size_t(header.size) - used);
+		data.resize(used + n);
+		in.read(reinterpret_cast<char*>(data.data() + used), n);
+
+		if (size_t(in.gcount()) != n)
+		{
+			return false;
+		}
+	}
+
+	ByteCursor events(data.data(), data.size());
+	return read_mtrk_events(events, receiver);
+}
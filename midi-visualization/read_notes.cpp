@@ -0,0 +1,221 @@
+#include "midi.h"
+#include "midi-buffer.h"
+#include "chunk-index.h"
+#include "note-decoder.h"
+#include "mtrk-validator.h"
+#include "parse-context.h"
+#include "static-receivers.h"
+#include <atomic>
+#include <algorithm>
+#include <thread>
+
+
+namespace
+{
+	bool read_file_header(const ChunkIndex& index, const MidiBuffer& buffer, MThd* mthd)
+	{
+		if (index.header_chunk() == nullptr)
+		{
+			return false;
+		}
+
+		ByteCursor cursor = buffer.cursor();
+		return read_mthd(cursor, mthd) && index.track_count() >= mthd->ntracks;
+	}
+
+	// Appends every note to a vector as soon as its note off is seen
+	template<typename Notes>
+	class NoteAppender
+	{
+	public:
+		NoteAppender(Notes* notes) : m_notes(notes) { }
+
+		void started(uint8_t, uint8_t, uint32_t) { }
+
+		void finished(uint8_t channel, uint8_t note, uint32_t start, uint32_t end)
+		{
+			m_notes->push_back(NOTE{ channel, note, start, end - start });
+		}
+
+	private:
+		Notes* m_notes;
+	};
+
+	template<typename Notes>
+	void read_track_notes_unchecked(const uint8_t* p, Notes* notes)
+	{
+		NoteAppender<Notes> appender(notes);
+		decode_notes_unchecked(p, appender);
+	}
+
+	template<typename Notes>
+	bool read_notes_fast_into(const MidiBuffer& buffer, Notes* notes, ChunkIndex& index, VALIDATION_ERROR* error)
+	{
+		MThd mthd;
+		size_t note_ons;
+
+		if (!validate_midi(buffer, error, &index, &mthd, &note_ons))
+		{
+			return false;
+		}
+
+		// Every note starts with a note on, so this is the most notes there can be
+		notes->reserve(notes->size() + note_ons);
+
+		for (size_t i = 0; i != mthd.ntracks; ++i)
+		{
+			read_track_notes_unchecked(index.chunk_data(index.track_entry(i)).position(), notes);
+		}
+
+		return true;
+	}
+}
+
+
+bool read_track_notes(ByteCursor& in, std::vector<NOTE>* notes)
+{
+	// One receiver for all channels; ChannelNoteCollector is final, so read_mtrk calls it directly
+	ChannelNoteCollector collector(notes);
+	return read_mtrk(in, collector);
+}
+
+bool read_notes(const MidiBuffer& buffer, std::vector<NOTE>* notes)
+{
+	ChunkIndex index;
+	MThd mthd;
+
+	if (!index.build(buffer) || !read_file_header(index, buffer, &mthd))
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i != mthd.ntracks; ++i)
+	{
+		ByteCursor track = index.track(i);
+
+		if (!read_track_notes(track, notes))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool read_notes(std::istream& in, std::vector<NOTE>* notes)
+{
+	MidiBuffer buffer;
+
+	return buffer.load(in) && read_notes(buffer, notes);
+}
+
+bool read_track_notes_fast(ByteCursor& in, std::vector<NOTE>* notes)
+{
+	CHUNK_HEADER header;
+
+	if (!read_header(in, &header) || header_id(header) != "MTrk")
+	{
+		return false;
+	}
+
+	ByteCursor events = in.split(header.size);
+	if (!events || !validate_mtrk_events(events.position(), events.remaining(), nullptr))
+	{
+		return false;
+	}
+
+	read_track_notes_unchecked(events.position(), notes);
+	return true;
+}
+
+bool read_notes_fast(const MidiBuffer& buffer, std::vector<NOTE>* notes, VALIDATION_ERROR* error)
+{
+	ChunkIndex index;
+
+	return read_notes_fast_into(buffer, notes, index, error);
+}
+
+bool read_notes_fast(const MidiBuffer& buffer, ArenaVector<NOTE>* notes, ChunkIndex* index, VALIDATION_ERROR* error)
+{
+	return read_notes_fast_into(buffer, notes, *index, error);
+}
+
+bool read_notes_fast(std::istream& in, std::vector<NOTE>* notes, VALIDATION_ERROR* error)
+{
+	MidiBuffer buffer;
+
+	if (!buffer.load(in))
+	{
+		return false;
+	}
+
+	return read_notes_fast(buffer, notes, error);
+}
+
+bool read_notes_parallel(const MidiBuffer& buffer, std::vector<NOTE>* notes, unsigned thread_count)
+{
+	ChunkIndex index;
+	MThd mthd;
+
+	if (!index.build(buffer) || !read_file_header(index, buffer, &mthd))
+	{
+		return false;
+	}
+
+	if (thread_count == 0)
+	{
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	// Format 0 has a single track and format 2 tracks are independent songs; only format 1 is split up
+	size_t ntracks = mthd.ntracks;
+	if (mthd.type != 1 || ntracks < 2 || thread_count == 1)
+	{
+		return read_notes(buffer, notes);
+	}
+
+	std::vector<std::vector<NOTE>> track_notes(ntracks);
+	std::vector<char> succeeded(ntracks, 0);
+	std::atomic<size_t> next_track(0);
+
+	auto worker = [&]() {
+		size_t i;
+
+		while ((i = next_track++) < ntracks)
+		{
+			ByteCursor track = index.track(i);
+			succeeded[i] = read_track_notes(track, &track_notes[i]);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (unsigned t = 1; t < std::min<size_t>(thread_count, ntracks); ++t)
+	{
+		threads.emplace_back(worker);
+	}
+	worker();
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	size_t total = 0;
+	for (size_t i = 0; i != ntracks; ++i)
+	{
+		if (!succeeded[i])
+		{
+			return false;
+		}
+
+		total += track_notes[i].size();
+	}
+
+	notes->reserve(notes->size() + total);
+	for (auto& part : track_notes)
+	{
+		notes->insert(notes->end(), part.begin(), part.end());
+	}
+
+	return true;
+}
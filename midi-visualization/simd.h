@@ -0,0 +1,28 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+/*
+	Decides which vector instruction sets the bulk kernels may use.
+	SSE2 is always there on x64; AVX2 only when the compiler is told so
+	(/arch:AVX2 or -mavx2). Define MIDI_NO_SIMD to force the scalar code.
+*/
+
+#ifndef MIDI_NO_SIMD
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIDI_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(MIDI_USE_SSE2) && defined(__AVX2__)
+#define MIDI_USE_AVX2
+#include <immintrin.h>
+#endif
+
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#endif
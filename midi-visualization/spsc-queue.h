@@ -0,0 +1,186 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+
+
+/*
+	Bounded lock-free queue for exactly one producer thread and one consumer thread.
+
+	The producer only writes m_tail and the consumer only writes m_head, each on
+	its own cache line. Each side also keeps a private copy of the other side's
+	index and only rereads the shared one when that copy says the queue is
+	full (or empty). Most operations therefore touch no cache line that the
+	other thread is writing.
+
+	try_push/try_pop never block. push/pop wait (spinning, then yielding) until
+	there is room or data, which is how a fast producer is held back by a slow
+	consumer. The capacity is rounded up to a power of two. Nothing is allocated
+	after construction.
+*/
+template<typename T>
+class SpscQueue
+{
+public:
+	explicit SpscQueue(size_t capacity)
+		: m_capacity(round_up_to_power_of_two(capacity < 2 ? 2 : capacity))
+		, m_mask(m_capacity - 1)
+		, m_items(new T[m_capacity])
+		, m_head(0)
+		, m_cached_tail(0)
+		, m_tail(0)
+		, m_cached_head(0)
+	{
+		// NOP
+	}
+
+	SpscQueue(const SpscQueue&) = delete;
+	SpscQueue& operator =(const SpscQueue&) = delete;
+
+	size_t capacity() const { return m_capacity; }
+
+	// Producer side
+
+	bool try_push(const T& item)
+	{
+		return try_push(&item, 1) == 1;
+	}
+
+	// Pushes as many of the n items as fit and returns how many that was.
+	size_t try_push(const T* items, size_t n)
+	{
+		size_t tail = m_tail.load(std::memory_order_relaxed);
+		size_t room = m_capacity - (tail - m_cached_head);
+
+		if (room < n)
+		{
+			m_cached_head = m_head.load(std::memory_order_acquire);
+			room = m_capacity - (tail - m_cached_head);
+		}
+
+		n = n < room ? n : room;
+		for (size_t i = 0; i != n; ++i)
+		{
+			m_items[(tail + i) & m_mask] = items[i];
+		}
+
+		m_tail.store(tail + n, std::memory_order_release);
+		return n;
+	}
+
+	void push(const T& item)
+	{
+		push(&item, 1);
+	}
+
+	void push(const T* items, size_t n)
+	{
+		unsigned attempts = 0;
+
+		while (n != 0)
+		{
+			size_t pushed = try_push(items, n);
+			items += pushed;
+			n -= pushed;
+
+			if (n != 0)
+			{
+				back_off(attempts);
+			}
+		}
+	}
+
+	// Consumer side
+
+	bool try_pop(T* item)
+	{
+		return try_pop(item, 1) == 1;
+	}
+
+	// Pops up to n items and returns how many there were.
+	size_t try_pop(T* items, size_t n)
+	{
+		size_t head = m_head.load(std::memory_order_relaxed);
+		size_t available = m_cached_tail - head;
+
+		if (available < n)
+		{
+			m_cached_tail = m_tail.load(std::memory_order_acquire);
+			available = m_cached_tail - head;
+		}
+
+		n = n < available ? n : available;
+		for (size_t i = 0; i != n; ++i)
+		{
+			items[i] = m_items[(head + i) & m_mask];
+		}
+
+		m_head.store(head + n, std::memory_order_release);
+		return n;
+	}
+
+	void pop(T* item)
+	{
+		pop(item, 1);
+	}
+
+	void pop(T* items, size_t n)
+	{
+		unsigned attempts = 0;
+
+		while (n != 0)
+		{
+			size_t popped = try_pop(items, n);
+			items += popped;
+			n -= popped;
+
+			if (n != 0)
+			{
+				back_off(attempts);
+			}
+		}
+	}
+
+private:
+	static size_t round_up_to_power_of_two(size_t n)
+	{
+		size_t result = 1;
+
+		while (result < n)
+		{
+			result <<= 1;
+		}
+
+		return result;
+	}
+
+	static void back_off(unsigned& attempts)
+	{
+		// The other thread usually needs only a moment; give up the core if it takes longer
+		if (++attempts > 64)
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	static const size_t cache_line = 64;
+
+	const size_t m_capacity;
+	const size_t m_mask;
+	const std::unique_ptr<T[]> m_items;
+
+	// Written by the consumer
+	char m_padding0[cache_line];
+	std::atomic<size_t> m_head;
+	size_t m_cached_tail;
+
+	// Written by the producer
+	char m_padding1[cache_line];
+	std::atomic<size_t> m_tail;
+	size_t m_cached_head;
+	char m_padding2[cache_line];
+};
+
+#endif
@@ -0,0 +1,317 @@
+#ifndef STATIC_RECEIVERS_H
+#define STATIC_RECEIVERS_H
+#include "midi.h"
+#include "event-table.h"
+#include <tuple>
+#include <utility>
+
+
+/*
+	Compile-time counterpart of EventReceiver/EventMulticaster.
+
+	read_mtrk<Receiver> accepts any type with the nine event methods of EventReceiver
+	(note_on, note_off, ..., meta, sysex); they need not be virtual. wants_meta() and
+	wants_sysex() are optional and default to true. Because the receiver's type is known,
+	every event is a direct call the compiler can inline, where read_mtrk(ByteCursor&, EventReceiver&)
+	makes a virtual call per event (and EventMulticaster one more per downstream receiver).
+
+	StaticMulticaster<R...> fans events out to a fixed list of receivers, again without
+	virtual calls. EventReceiverAdapter<R> goes the other way: it wraps a static receiver
+	in an EventReceiver so it can take part in runtime composition (an EventMulticaster,
+	an MtrkParser, ...).
+
+		NoteFilter low(0, &notes), drums(9, &notes);
+		auto both = make_static_multicaster(low, drums);
+		read_mtrk(cursor, both);
+*/
+
+
+namespace receiver_details
+{
+	// Overload resolution prefers int over long, so the first version is picked when it compiles
+	template<typename Receiver>
+	auto wants_meta(const Receiver& receiver, int) -> decltype(bool(receiver.wants_meta()))
+	{
+		return receiver.wants_meta();
+	}
+
+	template<typename Receiver>
+	bool wants_meta(const Receiver&, long)
+	{
+		return true;
+	}
+
+	template<typename Receiver>
+	auto wants_sysex(const Receiver& receiver, int) -> decltype(bool(receiver.wants_sysex()))
+	{
+		return receiver.wants_sysex();
+	}
+
+	template<typename Receiver>
+	bool wants_sysex(const Receiver&, long)
+	{
+		return true;
+	}
+
+	// Calls f on every element of a tuple, in order
+	template<typename Tuple, typename F, size_t... I>
+	void for_each(Tuple& tuple, F&& f, std::index_sequence<I...>)
+	{
+		(void)std::initializer_list<int>{ (f(std::get<I>(tuple)), 0)... };
+	}
+
+	template<typename Tuple, typename F, size_t... I>
+	bool any_of(const Tuple& tuple, F&& f, std::index_sequence<I...>)
+	{
+		bool result = false;
+		(void)std::initializer_list<int>{ (result = f(std::get<I>(tuple)) || result, 0)... };
+		return result;
+	}
+}
+
+template<typename Receiver>
+bool receiver_wants_meta(const Receiver& receiver)
+{
+	return receiver_details::wants_meta(receiver, 0);
+}
+
+template<typename Receiver>
+bool receiver_wants_sysex(const Receiver& receiver)
+{
+	return receiver_details::wants_sysex(receiver, 0);
+}
+
+
+/*
+	Reads the events of an MTrk chunk (without its header) until the end of track
+	meta event (0x2F), which must coincide with the end of the chunk data.
+*/
+template<typename Receiver>
+bool read_mtrk_events(ByteCursor& in, Receiver& receiver)
+{
+	const bool deliver_meta = receiver_wants_meta(receiver);
+	const bool deliver_sysex = receiver_wants_sysex(receiver);
+	uint8_t running_status = 0;
+	uint32_t skipped_dt = 0;
+
+	while (true)
+	{
+		uint32_t dt = read_variable_length_integer(in) + skipped_dt;
+		skipped_dt = 0;
+
+		if (!in || in.at_end())
+		{
+			return false;
+		}
+
+		uint8_t status = *in.position();
+		EVENT_INFO info = event_table[status];
+
+		if (info.event_class != EventClass::Data)
+		{
+			in.skip(1);
+		}
+		else if (running_status != 0)
+		{
+			status = running_status;
+			info = event_table[status];
+		}
+		else
+		{
+			return false;
+		}
+
+		if (info.running_status)
+		{
+			running_status = status;
+
+			uint8_t first = read_byte(in);
+			uint8_t second = info.data_length == 2 ? read_byte(in) : 0;
+
+			if (!in)
+			{
+				return false;
+			}
+
+			dispatch_channel_event(receiver, info.event_class, dt, status, first, second);
+		}
+		else if (info.event_class == EventClass::Meta)
+		{
+			uint8_t type = read_byte(in);
+			uint32_t length = read_variable_length_integer(in);
+			const uint8_t* data = in.take(length);
+
+			if (!in)
+			{
+				return false;
+			}
+
+			if (deliver_meta)
+			{
+				receiver.meta(dt, type, reinterpret_cast<const char*>(data), int(length));
+			}
+			else
+			{
+				skipped_dt = dt;
+			}
+
+			if (type == 0x2F)
+			{
+				return in.at_end();
+			}
+		}
+		else if (info.event_class == EventClass::Sysex)
+		{
+			uint32_t length = read_variable_length_integer(in);
+			const uint8_t* data = in.take(length);
+
+			if (!in)
+			{
+				return false;
+			}
+
+			if (deliver_sysex)
+			{
+				receiver.sysex(dt, reinterpret_cast<const char*>(data), int(length));
+			}
+			else
+			{
+				skipped_dt = dt;
+			}
+		}
+		else
+		{
+			// System common/real-time messages cannot appear in a MIDI file
+			return false;
+		}
+	}
+}
+
+// Same as read_mtrk(ByteCursor&, EventReceiver&), for any receiver type.
+template<typename Receiver>
+bool read_mtrk(ByteCursor& in, Receiver& receiver)
+{
+	CHUNK_HEADER header;
+
+	if (!read_header(in, &header) || header_id(header) != "MTrk")
+	{
+		return false;
+	}
+
+	ByteCursor events = in.split(header.size);
+
+	if (!events)
+	{
+		return false;
+	}
+
+	return read_mtrk_events(events, receiver);
+}
+
+
+/*
+	Forwards every event to each of its receivers, in order, like EventMulticaster.
+	The receivers are held by reference and must outlive the multicaster.
+*/
+template<typename... Receivers>
+class StaticMulticaster
+{
+public:
+	explicit StaticMulticaster(Receivers&... receivers) : m_receivers(receivers...) { }
+
+	bool wants_meta() const
+	{
+		return receiver_details::any_of(m_receivers, [](const auto& r) { return receiver_wants_meta(r); }, indices());
+	}
+
+	bool wants_sysex() const
+	{
+		return receiver_details::any_of(m_receivers, [](const auto& r) { return receiver_wants_sysex(r); }, indices());
+	}
+
+	void note_on(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity)
+	{
+		receiver_details::for_each(m_receivers, [=](auto& r) { r.note_on(dt, channel, note, velocity); }, indices());
+	}
+
+	void note_off(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity)
+	{
+		receiver_details::for_each(m_receivers, [=](auto& r) { r.note_off(dt, channel, note, velocity); }, indices());
+	}
+
+	void polyphonic_key_pressure(uint32_t dt, uint8_t channel, uint8_t note, uint8_t pressure)
+	{
+		receiver_details::for_each(m_receivers, [=](auto& r) { r.polyphonic_key_pressure(dt, channel, note, pressure); }, indices());
+	}
+
+	void control_change(uint32_t dt, uint8_t channel, uint8_t controller, uint8_t value)
+	{
+		receiver_details::for_each(m_receivers, [=](auto& r) { r.control_change(dt, channel, controller, value); }, indices());
+	}
+
+	void program_change(uint32_t dt, uint8_t channel, uint8_t program)
+	{
+		receiver_details::for_each(m_receivers, [=](auto& r) { r.program_change(dt, channel, program); }, indices());
+	}
+
+	void channel_pressure(uint32_t dt, uint8_t channel, uint8_t pressure)
+	{
+		receiver_details::for_each(m_receivers, [=](auto& r) { r.channel_pressure(dt, channel, pressure); }, indices());
+	}
+
+	void pitch_wheel_change(uint32_t dt, uint8_t channel, uint16_t value)
+	{
+		receiver_details::for_each(m_receivers, [=](auto& r) { r.pitch_wheel_change(dt, channel, value); }, indices());
+	}
+
+	void meta(uint32_t dt, uint8_t type, const char* data, int data_size)
+	{
+		receiver_details::for_each(m_receivers, [=](auto& r) { r.meta(dt, type, data, data_size); }, indices());
+	}
+
+	void sysex(uint32_t dt, const char* data, int data_size)
+	{
+		receiver_details::for_each(m_receivers, [=](auto& r) { r.sysex(dt, data, data_size); }, indices());
+	}
+
+private:
+	static std::index_sequence_for<Receivers...> indices() { return {}; }
+
+	std::tuple<Receivers&...> m_receivers;
+};
+
+template<typename... Receivers>
+StaticMulticaster<Receivers...> make_static_multicaster(Receivers&... receivers)
+{
+	return StaticMulticaster<Receivers...>(receivers...);
+}
+
+
+/*
+	Makes a static receiver usable wherever an EventReceiver is expected.
+	The wrapped receiver is held by reference.
+*/
+template<typename Receiver>
+class EventReceiverAdapter final : public EventReceiver
+{
+public:
+	explicit EventReceiverAdapter(Receiver& receiver) : m_receiver(receiver) { }
+
+	bool wants_meta() const override { return receiver_wants_meta(m_receiver); }
+	bool wants_sysex() const override { return receiver_wants_sysex(m_receiver); }
+
+	void note_on(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) override { m_receiver.note_on(dt, channel, note, velocity); }
+	void note_off(uint32_t dt, uint8_t channel, uint8_t note, uint8_t velocity) override { m_receiver.note_off(dt, channel, note, velocity); }
+	void polyphonic_key_pressure(uint32_t dt, uint8_t channel, uint8_t note, uint8_t pressure) override { m_receiver.polyphonic_key_pressure(dt, channel, note, pressure); }
+	void control_change(uint32_t dt, uint8_t channel, uint8_t controller, uint8_t value) override { m_receiver.control_change(dt, channel, controller, value); }
+	void program_change(uint32_t dt, uint8_t channel, uint8_t program) override { m_receiver.program_change(dt, channel, program); }
+	void channel_pressure(uint32_t dt, uint8_t channel, uint8_t pressure) override { m_receiver.channel_pressure(dt, channel, pressure); }
+	void pitch_wheel_change(uint32_t dt, uint8_t channel, uint16_t value) override { m_receiver.pitch_wheel_change(dt, channel, value); }
+	void meta(uint32_t dt, uint8_t type, const char* data, int data_size) override { m_receiver.meta(dt, type, data, data_size); }
+	void sysex(uint32_t dt, const char* data, int data_size) override { m_receiver.sysex(dt, data, data_size); }
+
+private:
+	Receiver& m_receiver;
+};
+
+#endif
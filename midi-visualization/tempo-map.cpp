@@ -0,0 +1,160 @@
+#include "tempo-map.h"
+#include "chunk-index.h"
+#include <algorithm>
+
+
+namespace
+{
+	const uint32_t default_tempo = 500000;
+
+	// Keeps track of the absolute time and records every set tempo event.
+	class TempoCollector : public EventReceiver
+	{
+	public:
+		TempoCollector(std::vector<TEMPO_CHANGE>* changes) : m_changes(changes), m_time(0) { }
+
+		bool wants_sysex() const override { return false; }
+
+		void note_on(uint32_t dt, uint8_t, uint8_t, uint8_t) override { m_time += dt; }
+		void note_off(uint32_t dt, uint8_t, uint8_t, uint8_t) override { m_time += dt; }
+		void polyphonic_key_pressure(uint32_t dt, uint8_t, uint8_t, uint8_t) override { m_time += dt; }
+		void control_change(uint32_t dt, uint8_t, uint8_t, uint8_t) override { m_time += dt; }
+		void program_change(uint32_t dt, uint8_t, uint8_t) override { m_time += dt; }
+		void channel_pressure(uint32_t dt, uint8_t, uint8_t) override { m_time += dt; }
+		void pitch_wheel_change(uint32_t dt, uint8_t, uint16_t) override { m_time += dt; }
+		void sysex(uint32_t dt, const char*, int) override { m_time += dt; }
+
+		void meta(uint32_t dt, uint8_t type, const char* data, int data_size) override
+		{
+			m_time += dt;
+
+			if (type == 0x51 && data_size == 3)
+			{
+				const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+				uint32_t tempo = (uint32_t(bytes[0]) << 16) | (uint32_t(bytes[1]) << 8) | bytes[2];
+
+				m_changes->push_back(TEMPO_CHANGE{ m_time, tempo });
+			}
+		}
+
+	private:
+		std::vector<TEMPO_CHANGE>* m_changes;
+		uint32_t m_time;
+	};
+}
+
+
+TempoMap::TempoMap(uint16_t division, std::vector<TEMPO_CHANGE> changes)
+{
+	if (division & 0x8000)
+	{
+		int frames_per_second = -int(int8_t(division >> 8));
+		uint64_t ticks_per_frame = std::max(1, division & 0xFF);
+
+		// 29 means 29.97 = 30000 / 1001 frames per second
+		if (frames_per_second == 29)
+		{
+			m_segments.push_back(SEGMENT{ 0, 0, 1001 * 1000000ull, 30000 * ticks_per_frame });
+		}
+		else
+		{
+			m_segments.push_back(SEGMENT{ 0, 0, 1000000, uint64_t(std::max(1, frames_per_second)) * ticks_per_frame });
+		}
+
+		return;
+	}
+
+	uint64_t ticks_per_quarter_note = std::max<uint16_t>(1, division);
+
+	std::stable_sort(changes.begin(), changes.end(), [](const TEMPO_CHANGE& a, const TEMPO_CHANGE& b) {
+		return a.tick < b.tick;
+	});
+
+	m_segments.push_back(SEGMENT{ 0, 0, default_tempo, ticks_per_quarter_note });
+
+	for (auto& change : changes)
+	{
+		SEGMENT& last = m_segments.back();
+
+		if (change.tick == last.tick)
+		{
+			last.numerator = change.microseconds_per_quarter_note;
+		}
+		else
+		{
+			m_segments.push_back(SEGMENT{ change.tick, time_in(last, change.tick), change.microseconds_per_quarter_note, ticks_per_quarter_note });
+		}
+	}
+}
+
+size_t TempoMap::find_segment(uint64_t tick) const
+{
+	// Last segment that starts at or before tick; the first one starts at tick 0
+	auto next = std::upper_bound(m_segments.begin() + 1, m_segments.end(), tick, [](uint64_t t, const SEGMENT& segment) {
+		return t < segment.tick;
+	});
+
+	return size_t(next - m_segments.begin()) - 1;
+}
+
+uint64_t TempoMap::microseconds(uint64_t tick) const
+{
+	return time_in(m_segments[find_segment(tick)], tick);
+}
+
+void TempoMap::convert(const std::vector<NOTE>& notes, std::vector<NOTE_TIME>* times) const
+{
+	times->resize(notes.size());
+
+	size_t segment = 0;
+	const size_t last = m_segments.size() - 1;
+
+	for (size_t i = 0; i != notes.size(); ++i)
+	{
+		const NOTE& note = notes[i];
+		uint64_t end = uint64_t(note.start) + note.duration;
+
+		while (segment != last && m_segments[segment + 1].tick <= note.start)
+		{
+			++segment;
+		}
+
+		// Most notes end in the segment they start in, so only search further if they don't
+		size_t end_segment = segment;
+		if (end_segment != last && m_segments[end_segment + 1].tick <= end)
+		{
+			end_segment = find_segment(end);
+		}
+
+		uint64_t start_time = time_in(m_segments[segment], note.start);
+		uint64_t end_time = time_in(m_segments[end_segment], end);
+
+		(*times)[i] = NOTE_TIME{ start_time, end_time - start_time };
+	}
+}
+
+bool read_tempo_changes(const MidiBuffer& buffer, uint16_t* division, std::vector<TEMPO_CHANGE>* changes)
+{
+	ChunkIndex index;
+	ByteCursor cursor = buffer.cursor();
+	MThd mthd;
+
+	if (!index.build(buffer) || !read_mthd(cursor, &mthd) || mthd.division == 0 || index.track_count() < mthd.ntracks)
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i != mthd.ntracks; ++i)
+	{
+		TempoCollector collector(changes);
+		ByteCursor track = index.track(i);
+
+		if (!read_mtrk(track, collector))
+		{
+			return false;
+		}
+	}
+
+	*division = mthd.division;
+	return true;
+}
@@ -0,0 +1,83 @@
+#ifndef TEMPO_MAP_H
+#define TEMPO_MAP_H
+#include "midi.h"
+#include "midi-buffer.h"
+#include <cstdint>
+#include <vector>
+
+
+struct TEMPO_CHANGE
+{
+	uint32_t tick;
+	uint32_t microseconds_per_quarter_note; // payload of a set tempo meta event (0x51)
+};
+
+// Start and duration of a NOTE in microseconds.
+struct NOTE_TIME
+{
+	uint64_t start;
+	uint64_t duration;
+};
+
+
+/*
+	Converts ticks to wall clock time.
+
+	With a metrical division (high bit clear) the time between two tempo changes
+	grows linearly with the ticks, so the map is a list of segments that each
+	remember at which tick they start, the time of that tick (the sum of all
+	earlier segments) and their microseconds per tick. Looking up a tick is a
+	binary search over the segments.
+
+	With an SMPTE division (high bit set: -frames per second in the high byte,
+	ticks per frame in the low byte) ticks have a fixed length and tempo changes
+	are ignored. -29 stands for 29.97 frames per second.
+
+	Until the first tempo change the tempo is 120 beats per minute (500000 µs per quarter note).
+*/
+class TempoMap
+{
+public:
+	// changes may come in any order; of several changes on the same tick, the last one wins.
+	TempoMap(uint16_t division, std::vector<TEMPO_CHANGE> changes);
+
+	// 64 bit ticks, so that the end of a note (start + duration) can be passed without wrapping
+	uint64_t microseconds(uint64_t tick) const;
+	double seconds(uint64_t tick) const { return microseconds(tick) / 1000000.0; }
+
+	/*
+		Converts a whole array of notes at once. notes must be sorted by start;
+		the starts are then converted in one pass that walks the segments along
+		with the notes. times gets one entry per note, in the same order.
+	*/
+	void convert(const std::vector<NOTE>& notes, std::vector<NOTE_TIME>* times) const;
+
+	size_t segment_count() const { return m_segments.size(); }
+
+private:
+	struct SEGMENT
+	{
+		uint32_t tick;
+		uint64_t microseconds;
+		uint64_t numerator; // microseconds per tick = numerator / denominator
+		uint64_t denominator;
+	};
+
+	static uint64_t time_in(const SEGMENT& segment, uint64_t tick)
+	{
+		return segment.microseconds + (tick - segment.tick) * segment.numerator / segment.denominator;
+	}
+
+	size_t find_segment(uint64_t tick) const;
+
+	std::vector<SEGMENT> m_segments;
+};
+
+/*
+	Collects the division and the set tempo events of all tracks, i.e. everything
+	needed to build the TempoMap of a file.
+	Returns false if the file cannot be read or its division is 0.
+*/
+bool read_tempo_changes(const MidiBuffer& buffer, uint16_t* division, std::vector<TEMPO_CHANGE>* changes);
+
+#endif
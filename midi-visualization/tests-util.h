@@ -3,8 +3,11 @@
 
 #include "Catch.h"
 #include "midi.h"
+#include "midi-buffer.h"
+#include "chunk-index.h"
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 #include <list>
 
@@ -356,6 +359,45 @@ namespace testutils
             return std::make_unique<TestEventReceiver>(std::move(expected_events));
         }
     };
+
+    // The files in ../midi-files, without the .mid extension
+    const char* const sample_names[] = { "01", "02", "03", "04", "05", "06", "07", "08", "09", "10", "harmonies", "lengths", "stairs" };
+
+    inline std::string sample_path(const std::string& name)
+    {
+        return "../midi-files/" + name + ".mid";
+    }
+
+    inline MidiBuffer load_sample(const std::string& name)
+    {
+        MidiBuffer buffer;
+        REQUIRE(buffer.open(sample_path(name)));
+        return buffer;
+    }
+
+    // The notes of a sample file as read_notes finds them
+    inline std::vector<NOTE> load_sample_notes(const std::string& name)
+    {
+        MidiBuffer buffer = load_sample(name);
+        std::vector<NOTE> notes;
+        REQUIRE(read_notes(buffer, &notes));
+        return notes;
+    }
+
+    // One cursor per MTrk chunk, each starting at the chunk header
+    inline std::vector<ByteCursor> track_cursors(const MidiBuffer& buffer)
+    {
+        ChunkIndex index;
+        std::vector<ByteCursor> result;
+
+        REQUIRE(index.build(buffer));
+        for (size_t i = 0; i != index.track_count(); ++i)
+        {
+            result.push_back(index.track(i));
+        }
+
+        return result;
+    }
 }
 
 
@@ -0,0 +1,140 @@
+#include "work-stealing-pool.h"
+#include <algorithm>
+
+
+namespace
+{
+	// Lets submit() find out whether it is called from one of the pool's own workers
+	thread_local const WorkStealingPool* current_pool = nullptr;
+	thread_local unsigned current_worker = 0;
+}
+
+
+WorkStealingPool::WorkStealingPool(unsigned thread_count)
+	: m_next_worker(0)
+	, m_queued(0)
+	, m_pending(0)
+	, m_stopping(false)
+{
+	if (thread_count == 0)
+	{
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	for (unsigned i = 0; i != thread_count; ++i)
+	{
+		m_workers.push_back(std::unique_ptr<Worker>(new Worker));
+	}
+
+	for (unsigned i = 0; i != thread_count; ++i)
+	{
+		m_threads.emplace_back([this, i]() { run(i); });
+	}
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+	wait();
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_work_available.notify_all();
+
+	for (auto& thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+void WorkStealingPool::submit(std::function<void()> task)
+{
+	unsigned index = current_pool == this ? current_worker : m_next_worker++ % thread_count();
+	Worker& worker = *m_workers[index];
+
+	{
+		// Counted before the task becomes visible, so that it cannot finish (and be
+		// subtracted) before it was added, and under m_mutex, so that a worker about
+		// to go to sleep cannot miss it
+		std::lock_guard<std::mutex> lock(m_mutex);
+		++m_pending;
+		++m_queued;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		worker.tasks.push_back(std::move(task));
+	}
+	m_work_available.notify_one();
+}
+
+void WorkStealingPool::wait()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_all_done.wait(lock, [this]() { return m_pending == 0; });
+}
+
+bool WorkStealingPool::take_task(unsigned index, std::function<void()>* task)
+{
+	{
+		Worker& own = *m_workers[index];
+		std::lock_guard<std::mutex> lock(own.mutex);
+
+		if (!own.tasks.empty())
+		{
+			*task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+			return true;
+		}
+	}
+
+	for (unsigned offset = 1; offset != thread_count(); ++offset)
+	{
+		Worker& victim = *m_workers[(index + offset) % thread_count()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+
+		if (!victim.tasks.empty())
+		{
+			*task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void WorkStealingPool::run(unsigned index)
+{
+	current_pool = this;
+	current_worker = index;
+
+	std::function<void()> task;
+
+	while (true)
+	{
+		if (take_task(index, &task))
+		{
+			--m_queued;
+			task();
+			task = nullptr;
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (--m_pending == 0)
+			{
+				m_all_done.notify_all();
+			}
+		}
+		else
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_work_available.wait(lock, [this]() { return m_queued != 0 || m_stopping; });
+
+			if (m_stopping && m_queued == 0)
+			{
+				return;
+			}
+		}
+	}
+}
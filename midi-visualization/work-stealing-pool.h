@@ -0,0 +1,62 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/*
+	Thread pool in which every worker has its own task queue.
+
+	A task submitted from inside a worker goes to the back of that worker's queue,
+	and the worker takes its own tasks from the back as well (newest first, while
+	their data is still in cache). A worker whose queue is empty steals from the
+	front of the other queues, i.e. the oldest and usually biggest tasks.
+	Tasks submitted from outside the pool are dealt out round robin.
+*/
+class WorkStealingPool
+{
+public:
+	// thread_count 0 means one worker per hardware thread.
+	explicit WorkStealingPool(unsigned thread_count = 0);
+	~WorkStealingPool();
+
+	WorkStealingPool(const WorkStealingPool&) = delete;
+	WorkStealingPool& operator =(const WorkStealingPool&) = delete;
+
+	void submit(std::function<void()> task);
+
+	// Blocks until every submitted task, including those submitted by other tasks, has finished.
+	// Must not be called from inside a task.
+	void wait();
+
+	unsigned thread_count() const { return unsigned(m_workers.size()); }
+
+private:
+	struct Worker
+	{
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	void run(unsigned index);
+	bool take_task(unsigned index, std::function<void()>* task);
+
+	std::vector<std::unique_ptr<Worker>> m_workers;
+	std::vector<std::thread> m_threads;
+	std::atomic<unsigned> m_next_worker;
+	std::atomic<size_t> m_queued;
+
+	std::mutex m_mutex;
+	std::condition_variable m_work_available;
+	std::condition_variable m_all_done;
+	size_t m_pending;
+	bool m_stopping;
+};
+
+#endif